@@ -11,6 +11,81 @@ StopWatch Application::createStopWatchForPerformanceMeasurement() {
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+bool Application::processProjectRound() {
+	double startTime = getTimeSeconds();
+
+	unique_ptr<CppProject> cppProject = make_unique<CppProject>(config.get(), errorList.get());
+	errorList->runWithExceptionCheck([&] {
+		cppProject->processProject();
+	});
+
+	if (errorList->hasErrors()) {
+		return false;
+	}
+
+	CppStatistics stats = cppProject->calculateTotalStatistics();
+	StopWatch stopWatch = createStopWatchForPerformanceMeasurement();
+	cppProject.reset(nullptr);
+	stopWatch.mark("clean-up");
+
+	double secondsElapsed = getTimeSeconds() - startTime;
+	performanceCounts.add("total time", secondsElapsed);
+	if (config->showStatistics) {
+		if (stats.linkingSkipped) {
+			LOG_INFO(sb() << "Processed " << (stats.numSourceBytes / 1048576.0) << " MB (" << stats.numSourceFiles << " files, " << stats.numClasses << " classes; all partitions up-to-date, linking skipped) in " << secondsElapsed << " seconds (" << (stats.numSourceBytes / 1048576.0 / secondsElapsed) << " MB/s)");
+		}
+		else {
+			LOG_INFO(sb() << "Processed " << (stats.numSourceBytes / 1048576.0) << " MB (" << stats.numSourceFiles << " files, " << stats.numClasses << " classes, " << stats.numFunctions << " functions) in " << secondsElapsed << " seconds (" << (stats.numSourceBytes / 1048576.0 / secondsElapsed) << " MB/s)");
+		}
+		if (stats.numParseTasks > 0) {
+			// If the efficiency is low, the elapsed time is bound by the longest task (critical path) rather than the total work.
+			LOG_INFO(sb() << "Parsing: " << stats.parseWallSeconds << " seconds elapsed, " << stats.parseTaskSeconds << " seconds of work in " << stats.numParseTasks << " tasks (longest " << stats.longestParseTaskSeconds << " seconds), parallel efficiency " << (stats.getParallelParseEfficiency() * 100.0) << "% with " << stats.numParseThreads << " threads");
+		}
+	}
+	LOG_INFO("Cross-language bindings generated successfully.");
+	return true;
+}
+
+unique_ptr<FileChangeWatcher> Application::createSourceFileWatcher() {
+	vector<Path> sourceDirs;
+	for (const Config::Partition &partition : config->partitions) {
+		if (!partition.cppSourceDir.empty()) {
+			sourceDirs.push_back(partition.cppSourceDir);
+		}
+	}
+
+	vector<string> outputDirs;
+	for (const auto &entry : config->outputDirsByType) {
+		if (entry.second.isValid()) {
+			outputDirs.push_back(entry.second.path.toString());
+		}
+	}
+
+	return make_unique<FileChangeWatcher>(sourceDirs, [outputDirs](const string &path, bool isDirectory) {
+		// Ignore the generated files, because they may be under a source directory.
+		for (const string &dir : outputDirs) {
+			if (isPathSameOrDescendantOf(path, dir)) return false;
+		}
+		return isDirectory || CppSourceDirectory::isHeaderFileName(path) || CppSourceDirectory::isSourceFileName(path);
+	});
+}
+
+void Application::processProjectWheneverSourceFilesChange(FileChangeWatcher *watcher) {
+	// Wait a while after a change so that if multiple files are saved at once, they are processed in the same round.
+	int quietPeriodMilliseconds = 50;
+
+	while (true) {
+		LOG_INFO("Watching source files for changes...");
+		watcher->waitForChanges(quietPeriodMilliseconds);
+
+		LOG_DETAIL("Source files changed, processing project");
+		if (!processProjectRound()) {
+			errorList->showErrors();
+			errorList->clear();
+		}
+	}
+}
+
 int Application::run(int argc, char *argv[]) {
 	int returnCode = 0;
 	errorList.reset(new ErrorList());
@@ -23,7 +98,12 @@ int Application::run(int argc, char *argv[]) {
 
 		cppParseUtil.reset(new CppParseUtil());
 		CppTokenizerTables::instance.reset(new CppTokenizerTables());
-		CppTokenizerTables::instance->init();
+		CppTokenizerTables::instance->init(config->exportKeyword, config->exportKeywordWithParameters);
+
+		if (config->tokenizerBenchmarkMode) {
+			runTokenizerBenchmark();
+			return;
+		}
 
 		if (!config->perfTestMode) {
 			// Run with lower process priority to avoid making the IDE slow while building.
@@ -33,37 +113,45 @@ int Application::run(int argc, char *argv[]) {
 		threadPool.reset(new ThreadPool(config->maxThreads));
 		threadPool->start();
 
+		if (!config->parseCacheFile.empty() || config->watchMode) {
+			// In watch mode, the parse results are kept in memory between rounds even if the cache file is not used.
+			parseCache.reset(new CppParseCache(config->parseCacheFile, config->getParserSettingsForCache()));
+			parseCache->load();
+		}
+
+		if (!config->outputManifestFile.empty() || config->watchMode) {
+			// Same as with the parse cache, so that the rounds after the first one regenerate only the partitions whose inputs have changed,
+			// and skip linking if none have.
+			outputManifest.reset(new OutputManifest(config->outputManifestFile));
+			outputManifest->load();
+		}
+
+		// Start watching before the first round so that changes made during it are not missed.
+		unique_ptr<FileChangeWatcher> watcher;
+		if (config->watchMode) {
+			watcher = createSourceFileWatcher();
+		}
+
 		int rounds = 1;
 		if (config->perfTestMode) {
 			LOG_INFO("Running performance test");
 			rounds = 100;
 		}
 		for (int round = 0; round < rounds; round++) {
-			double startTime = getTimeSeconds();
-
-			unique_ptr<CppProject> cppProject = make_unique<CppProject>(config.get(), errorList.get());
-			cppProject->processProject();
-
-			if (errorList->hasErrors()) {
+			if (!processProjectRound()) {
 				break;
 			}
-			
-			CppStatistics stats = cppProject->calculateTotalStatistics();
-			StopWatch stopWatch = createStopWatchForPerformanceMeasurement();
-			cppProject.reset(nullptr);
-			stopWatch.mark("clean-up");
-
-			double secondsElapsed = getTimeSeconds() - startTime;
-			performanceCounts.add("total time", secondsElapsed);
-			if (config->showStatistics) {
-				LOG_INFO(sb() << "Processed " << (stats.numSourceBytes / 1048576.0) << " MB (" << stats.numSourceFiles << " files, " << stats.numClasses << " classes, " << stats.numFunctions << " functions) in " << secondsElapsed << " seconds (" << (stats.numSourceBytes / 1048576.0 / secondsElapsed) << " MB/s)");
-			}
-			LOG_INFO("Cross-language bindings generated successfully.");
 		}
 
 		if (config->perfTestMode) {
 			LOG(LogLevel::off, sb() << "Performance test results:\n" << performanceCounts.toString(true));
 		}
+
+		if (watcher) {
+			errorList->showErrors();
+			errorList->clear();
+			processProjectWheneverSourceFilesChange(watcher.get());
+		}
 	});
 
 	if (errorList->hasErrors()) {
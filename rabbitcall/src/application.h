@@ -7,12 +7,19 @@ public:
 
 	unique_ptr<Config> config;
 	unique_ptr<ThreadPool> threadPool;
+	unique_ptr<CppParseCache> parseCache;
+	unique_ptr<OutputManifest> outputManifest;
 	unique_ptr<CppProject> cppProject;
 	unique_ptr<ErrorList> errorList;
 	CountMap performanceCounts;
 
 	StopWatch createStopWatchForPerformanceMeasurement();
-	
+
+	// Returns false if there were errors.
+	bool processProjectRound();
+	unique_ptr<FileChangeWatcher> createSourceFileWatcher();
+	void processProjectWheneverSourceFilesChange(FileChangeWatcher *watcher);
+
 	int run(int argc, char *argv[]);
 };
 
@@ -152,6 +152,9 @@ Config::Config(int argc, char *argv[], ErrorList *errorList) {
 
 				i++;
 			}
+
+			// A flag parameter without a value may be the last one.
+			addCurrentCmdLineParamToMap("");
 		}
 
 		configFile = canonicalizePath(Path(cmdLineParams.getOrThrowAndMarkUsed("configFile")));
@@ -189,8 +192,29 @@ Config::Config(int argc, char *argv[], ErrorList *errorList) {
 		});
 		params.addAll(cmdLineParams, "Parameter defined both in command-line parameters and configuration file");
 
+		{
+			ByteBuffer configFileContent;
+			loadBinaryFile(&configFileContent, configFile);
+			StringBuilder settings;
+			settings << version << "\n";
+			settings.buffer.append((const char *)configFileContent.getBuffer(), configFileContent.getPosition());
+			bool skipValue = false;
+			for (int i = 1; i < argc; i++) {
+				string p = argv[i];
+				if (boost::starts_with(p, "-")) {
+					// The dry-run mode must be able to check files generated in the normal mode.
+					skipValue = (p == "-dryRun" || p == "-watch");
+				}
+				if (skipValue) continue;
+				settings << "\n" << p;
+			}
+			outputSettingsHash = calculateHash128(settings.buffer.data(), settings.buffer.size());
+		}
+
 		dryRunMode = params.hasParameterAndMarkUsed("dryRun");
 		perfTestMode = params.hasParameterAndMarkUsed("perfTest");
+		tokenizerBenchmarkMode = params.hasParameterAndMarkUsed("tokenizerBenchmark");
+		watchMode = params.hasParameterAndMarkUsed("watch");
 
 		logger->setLogLevel(Logger::parseLogLevel(params.getOrThrowAndMarkUsed("logLevel")));
 		logger->setMessagePrefix(params.getIfExistsAndMarkUsed("logMessagePrefix"));
@@ -214,6 +238,9 @@ Config::Config(int argc, char *argv[], ErrorList *errorList) {
 
 		cppLibraryFile = params.getOrThrowAndMarkUsed("cppLibraryFile");
 		includeSourceHeadersInGeneratedCpp = parseBool(params.getOrThrowAndMarkUsed("includeSourceHeadersInGeneratedCpp"));
+		generateCppFilePerSourceHeader = parseBool(params.getIfExistsAndMarkUsed("generateCppFilePerSourceHeader"));
+		keepSourceFileContentInMemory = parseBool(params.getIfExistsAndMarkUsed("keepSourceFileContentInMemory"));
+		stableEntryPointNames = parseBool(params.getIfExistsAndMarkUsed("stableEntryPointNames"));
 		exportKeyword = params.getOrThrowAndMarkUsed("exportKeyword");
 		exportKeywordWithParameters = exportKeyword + "P";
 		csClassNamePrefix = params.getIfExistsAndMarkUsed("csClassNamePrefix");
@@ -221,6 +248,12 @@ Config::Config(int argc, char *argv[], ErrorList *errorList) {
 		csNamespace = params.getIfExistsAndMarkUsed("csNamespace");
 		csGlobalFunctionContainerClass = params.getIfExistsAndMarkUsed("csGlobalFunctionContainerClass");
 
+		string csOutputSplit = params.getIfExistsAndMarkUsed("csOutputSplit");
+		if (csOutputSplit.empty() || csOutputSplit == "none") csOutputSplitMode = CsOutputSplitMode::NONE;
+		else if (csOutputSplit == "namespace") csOutputSplitMode = CsOutputSplitMode::NAMESPACE;
+		else if (csOutputSplit == "class") csOutputSplitMode = CsOutputSplitMode::CLASS;
+		else EXC(sb() << "Invalid csOutputSplit (should be 'none', 'namespace' or 'class'): " << csOutputSplit);
+
 		maxThreads = (int)getIntegerConfigValue("maxThreads");
 		if (maxThreads == 0) maxThreads = 16;
 		else if (maxThreads < 1 || maxThreads > 1000) EXC(sb() << "Invalid maxThreads: " << maxThreads);
@@ -229,6 +262,18 @@ Config::Config(int argc, char *argv[], ErrorList *errorList) {
 
 		generatedCppFilePrologue = params.getOrThrowAndMarkUsed("generatedCppFilePrologue");
 
+		if (parseBool(params.getIfExistsAndMarkUsed("useParseCache"))) {
+			OutputDir outputDir;
+			if (!tryGetOutputDirByType("cpp", &outputDir) && !tryGetOutputDirByType("h", &outputDir)) EXC("Parse cache requires a 'cpp' or 'h' output dir");
+			parseCacheFile = outputDir.path / Path("rabbitcall_parse_cache.bin");
+		}
+
+		if (parseBool(params.getIfExistsAndMarkUsed("useOutputManifest"))) {
+			OutputDir outputDir;
+			if (!tryGetOutputDirByType("cpp", &outputDir) && !tryGetOutputDirByType("h", &outputDir)) EXC("Output manifest requires a 'cpp' or 'h' output dir");
+			outputManifestFile = outputDir.path / Path("rabbitcall_output_manifest.bin");
+		}
+
 		for (const string &name : params.getUnusedNames()) {
 			errorList->addError(sb() << "Unknown configuration parameter: " << name);
 		}
@@ -258,3 +303,7 @@ bool Config::tryGetOutputDirByType(const string &type, OutputDir *result) {
 	return true;
 }
 
+string Config::getParserSettingsForCache() {
+	return sb() << version << "\n" << exportKeyword << "\n" << csClassNamePrefix << "\n" << csClassNameSuffix;
+}
+
@@ -8,6 +8,13 @@ enum class Language {
 };
 StringBuilder & operator<<(StringBuilder &b, Language o);
 
+// How the generated C# code of a partition is split to multiple files.
+enum class CsOutputSplitMode {
+	NONE,
+	NAMESPACE, // A file per C++ namespace.
+	CLASS // A file per exported class, and a file per namespace for global functions.
+};
+
 struct TypeNamesByLanguage {
 	string cppType;
 	string csType;
@@ -65,21 +72,30 @@ public:
 	string programName = "RabbitCall";
 	string version = "1.0.1";
 	bool perfTestMode = false;
+	bool tokenizerBenchmarkMode = false;
 	bool dryRunMode = false;
+	bool watchMode = false; // Keep running and process the project again whenever source files change.
 
 	Path cppProjectDir;
 	string cppLibraryFile;
 	bool includeSourceHeadersInGeneratedCpp = false;
+	bool generateCppFilePerSourceHeader = false; // Generate the glue code of each exported source header to a separate .cpp file.
+	bool stableEntryPointNames = false; // Derive the generated entry point and callback names from a hash of the signature instead of numbering them.
+	bool keepSourceFileContentInMemory = false; // Keep the content of files with exports in memory until linking instead of copying the declarations.
 	string exportKeyword;
 	string exportKeywordWithParameters;
 	string csClassNamePrefix;
 	string csClassNameSuffix;
 	string csNamespace;
 	string csGlobalFunctionContainerClass;
+	CsOutputSplitMode csOutputSplitMode = CsOutputSplitMode::NONE;
 	int maxThreads = 1;
 	bool showStatistics = false;
 	int64_t pointerSizeBits = 64;
 	string generatedCppFilePrologue;
+	Path parseCacheFile; // Empty if the parse cache is not used.
+	Path outputManifestFile; // Empty if the output manifest is not used.
+	Hash128 outputSettingsHash; // Hash of the version, configuration file and command-line parameters that may affect the generated files.
 	map<string, OutputDir> outputDirsByType;
 	vector<Partition> partitions;
 	vector<TypeMapping> typeMappings;
@@ -89,6 +105,9 @@ public:
 	string getApiClassName() { return programName + "Api"; }
 	int64_t getPointerSizeBytes() { return pointerSizeBits / 8; }
 	bool tryGetOutputDirByType(const string &type, OutputDir *result);
+
+	// Returns the configuration parameters that affect file parse results (a cached parse result is valid only if these are unchanged).
+	string getParserSettingsForCache();
 	
 };
 
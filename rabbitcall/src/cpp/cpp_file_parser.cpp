@@ -7,8 +7,8 @@ CppParsedFile::CppParsedFile(const shared_ptr<CppFile> &file)
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-shared_ptr<CppExportParameters> CppFileParser::parseExportParameters(CppElementIterator &elementIter) {
-	shared_ptr<CppExportParameters> result = make_shared<CppExportParameters>();
+CppExportParameters * CppFileParser::parseExportParameters(CppElementIterator &elementIter) {
+	CppExportParameters *result = parsedFile->arena.create<CppExportParameters>();
 
 	if (!elementIter.isValid() || elementIter.element.ch != '(') elementIter.throwParseException(sb() << "Expected parameters after export keyword " << config->exportKeywordWithParameters << " (use " << config->exportKeyword << " instead if you did not intend to give parameters)");
 	unordered_map<string, CppSourceCodeView> parameters = CppItemParseUtil::parseCommaSeparatedParameterMap(elementIter.getSubElements());
@@ -56,19 +56,19 @@ string CppFileParser::getLineText(int64_t lineNumber) {
 	int64_t startOffset = file->lineAndColumnNumberMap->getLineStartOffsetByLineNumber(lineNumber);
 	int64_t endOffset = file->lineAndColumnNumberMap->getLineStartOffsetByLineNumber(lineNumber + 1);
 
-	if (endOffset > startOffset && (*(content.getBuffer() + endOffset - 1)) == '\n') {
+	if (endOffset > startOffset && (*(content->getData() + endOffset - 1)) == '\n') {
 		endOffset--;
-		if (endOffset > startOffset && (*(content.getBuffer() + endOffset - 1)) == '\r') {
+		if (endOffset > startOffset && (*(content->getData() + endOffset - 1)) == '\r') {
 			endOffset--;
 		}
 	}
 
-	return string((const char *)(content.getBuffer() + startOffset), max((int64_t)0, endOffset - startOffset));
+	return string((const char *)(content->getData() + startOffset), max((int64_t)0, endOffset - startOffset));
 }
 
 bool CppFileParser::isLineAcceptedBetweenCommentAndDeclaration(int64_t lineNumber) {
-	const char *data = (const char *)content.getBuffer();
-	int64_t dataSize = content.getPosition();
+	const char *data = (const char *)content->getData();
+	int64_t dataSize = content->getSize();
 	int64_t i = file->lineAndColumnNumberMap->getLineStartOffsetByLineNumber(lineNumber);
 	for (; i < dataSize; i++) {
 		if (!cppParseUtil->isHorizontalSpace(data[i])) break;
@@ -80,9 +80,9 @@ bool CppFileParser::isLineAcceptedBetweenCommentAndDeclaration(int64_t lineNumbe
 	return false;
 }
 
-shared_ptr<CppComment> CppFileParser::parseCommentLinesAboveDeclaration(int64_t declarationOffset) {
+CppComment * CppFileParser::parseCommentLinesAboveDeclaration(int64_t declarationOffset) {
 	LineAndColumnNumberMap *lineAndColumnNumberMap = file->lineAndColumnNumberMap.get();
-	shared_ptr<CppComment> result = make_shared<CppComment>();
+	CppComment *result = parsedFile->arena.create<CppComment>();
 	if (!commentMap->entries.empty()) {
 		// Check if there are attributes such as [[nodiscard]] on lines between the comment and the declaration and skip them.
 		int64_t startLineNumber = lineAndColumnNumberMap->getLineAndColumnNumberByOffset(declarationOffset).line;
@@ -113,8 +113,8 @@ shared_ptr<CppComment> CppFileParser::parseCommentLinesAboveDeclaration(int64_t
 
 			// Don't accept the comment if there are non-whitespace characters before or after the comment on the same line
 			// (regardless of whether it is a single-line or multi-line comment).
-			if (!cppParseUtil->containsWhiteSpaceOnly((const char*)(content.getBuffer() + commentStartLineStartOffset), max((int64_t)0, commentEntry->startOffset - commentStartLineStartOffset)) ||
-				!cppParseUtil->containsWhiteSpaceOnly((const char *)(content.getBuffer() + commentEntry->endOffset), max((int64_t)0, declarationOrNextCommentLineStartOffset - commentEntry->endOffset))) {
+			if (!cppParseUtil->containsWhiteSpaceOnly((const char*)(content->getData() + commentStartLineStartOffset), max((int64_t)0, commentEntry->startOffset - commentStartLineStartOffset)) ||
+				!cppParseUtil->containsWhiteSpaceOnly((const char *)(content->getData() + commentEntry->endOffset), max((int64_t)0, declarationOrNextCommentLineStartOffset - commentEntry->endOffset))) {
 				break;
 			}
 
@@ -172,9 +172,9 @@ void CppFileParser::parseSuperclassListElement(CppElementIterator &elementIter,
 				break;
 			}
 
-			if (elementIter.element.text == "virtual") elementIter.throwParseException("Virtual base classes not supported");
+			if (elementIter.element.keyword == CppKeyword::VIRTUAL) elementIter.throwParseException("Virtual base classes not supported");
 
-			CppAccessModifier accessModifier = CppItemParseUtil::parseAccessModifier(elementIter.element.text);
+			CppAccessModifier accessModifier = CppItemParseUtil::parseAccessModifier(elementIter.element.keyword);
 			if (accessModifier != CppAccessModifier::UNKNOWN) {
 				result.accessModifier = accessModifier;
 				elementIter.moveToNext();
@@ -244,7 +244,7 @@ CppSourceCodeView CppFileParser::extractFunctionOrVariableDeclaration(CppElement
 	return elementIter.getSourceCode()->getSubRange(startIndex, endIndex);
 }
 
-bool CppFileParser::tryParseClass(CppElementIterator &elementIter, const string &namespacePrefix, CppClass *enclosingClassIfExists, shared_ptr<CppExportParameters> exportParameters) {
+bool CppFileParser::tryParseClass(CppElementIterator &elementIter, const string &namespacePrefix, CppClass *enclosingClassIfExists, CppExportParameters *exportParameters) {
 	CppElementIterator startElement = elementIter;
 	while (elementIter.isValid()) {
 		CppElementIterator::InfiniteLoopGuard loopGuard(&elementIter);
@@ -257,17 +257,18 @@ bool CppFileParser::tryParseClass(CppElementIterator &elementIter, const string
 
 		if (elementIter.element.type == CppElementType::IDENTIFIER) {
 			CppClassDeclarationType declType = CppClassDeclarationType::UNKNOWN;
-			string itemType = elementIter.element.text;
-			if (itemType == "class") declType = CppClassDeclarationType::CLASS;
-			if (itemType == "struct") declType = CppClassDeclarationType::STRUCT;
-			if (itemType == "enum") declType = CppClassDeclarationType::ENUM;
-			if (itemType == "union") elementIter.throwParseException("Union not supported");
+			CppKeyword itemType = elementIter.element.keyword;
+			StringView itemTypeName = elementIter.element.text;
+			if (itemType == CppKeyword::CLASS) declType = CppClassDeclarationType::CLASS;
+			if (itemType == CppKeyword::STRUCT) declType = CppClassDeclarationType::STRUCT;
+			if (itemType == CppKeyword::ENUM) declType = CppClassDeclarationType::ENUM;
+			if (itemType == CppKeyword::UNION) elementIter.throwParseException("Union not supported");
 			bool isClassOrStruct = (declType == CppClassDeclarationType::CLASS || declType == CppClassDeclarationType::STRUCT);
 
 			if (declType != CppClassDeclarationType::UNKNOWN) {
 				if (enclosingClassIfExists) elementIter.throwParseException(sb() << "Nested exported classes not supported, enclosing class: " << enclosingClassIfExists->typeNames.cppType);
 
-				shared_ptr<CppComment> comment = parseCommentLinesAboveDeclaration(elementIter.getElementStartFileOffset());
+				CppComment *comment = parseCommentLinesAboveDeclaration(elementIter.getElementStartFileOffset());
 
 				SourceLocation sourceLocation = elementIter.getSourceLocation();
 				elementIter.moveToNext();
@@ -275,7 +276,7 @@ bool CppFileParser::tryParseClass(CppElementIterator &elementIter, const string
 				// Check if this is an enum with a "class" keyword, i.e. "enum class MyEnum"
 				bool isClassEnum = false;
 				if (declType == CppClassDeclarationType::ENUM) {
-					if (elementIter.isValid() && elementIter.element.text == "class") {
+					if (elementIter.isValid() && elementIter.element.keyword == CppKeyword::CLASS) {
 						isClassEnum = true;
 						elementIter.moveToNext();
 					}
@@ -285,20 +286,20 @@ bool CppFileParser::tryParseClass(CppElementIterator &elementIter, const string
 
 				int64_t explicitAlignment = 0;
 				if (isClassOrStruct) {
-					if (elementIter.isValid() && elementIter.element.text == "alignas") {
+					if (elementIter.isValid() && elementIter.element.keyword == CppKeyword::ALIGNAS) {
 						elementIter.moveToNext();
 						explicitAlignment = CppItemParseUtil::parseAlignasParameter(elementIter);
 					}
 				}
 
 				if (!elementIter.isValid() || elementIter.element.type != CppElementType::IDENTIFIER) elementIter.throwParseException("Expected class/struct/enum name");
-				string unqualifiedClassName = elementIter.element.text;
+				string unqualifiedClassName = elementIter.element.text.toString();
 				elementIter.moveToNext();
 
 				string qualifiedClassName = namespacePrefix + unqualifiedClassName;
 
-				LOG_DEBUG(sb() << "Parsing " << itemType << ": " << qualifiedClassName);
-				shared_ptr<CppClass> clazz = make_shared<CppClass>();
+				LOG_DEBUG(sb() << "Parsing " << itemTypeName << ": " << qualifiedClassName);
+				CppClass *clazz = parsedFile->arena.create<CppClass>();
 				clazz->typeNames.cppType = qualifiedClassName;
 				parsedFile->classes.push_back(clazz);
 				clazz->isPassByValue = (declType == CppClassDeclarationType::ENUM || declType == CppClassDeclarationType::STRUCT);
@@ -329,17 +330,17 @@ bool CppFileParser::tryParseClass(CppElementIterator &elementIter, const string
 					else if (elementIter.element.ch == '{') {
 						if (declType == CppClassDeclarationType::CLASS) {
 							int oldBlockDepthLimit = elementIter.enterBlockAndGetOldLimit();
-							scanForExportDeclarationsSub(elementIter, qualifiedClassName + "::", clazz.get(), false);
+							scanForExportDeclarationsSub(elementIter, qualifiedClassName + "::", clazz, false);
 							elementIter.exitBlock(oldBlockDepthLimit, '}', false);
 						}
 						else if (declType == CppClassDeclarationType::STRUCT) {
 							int oldBlockDepthLimit = elementIter.enterBlockAndGetOldLimit();
-							parseStructBody(elementIter, clazz.get());
+							parseStructBody(elementIter, clazz);
 							elementIter.exitBlock(oldBlockDepthLimit, '}', false);
 						}
 						else if (declType == CppClassDeclarationType::ENUM) {
 							int oldBlockDepthLimit = elementIter.enterBlockAndGetOldLimit();
-							parseEnumBody(elementIter, clazz.get());
+							parseEnumBody(elementIter, clazz);
 							elementIter.exitBlock(oldBlockDepthLimit, '}', false);
 						}
 						else {
@@ -376,21 +377,21 @@ void CppFileParser::parseStructBody(CppElementIterator &elementIter, CppClass *c
 		CppElementIterator::InfiniteLoopGuard loopGuard(&elementIter);
 
 		if (elementIter.element.type == CppElementType::IDENTIFIER) {
-			string text = elementIter.element.text;
+			CppKeyword keyword = elementIter.element.keyword;
 
-			CppAccessModifier accessModifier = CppItemParseUtil::parseAccessModifier(text);
+			CppAccessModifier accessModifier = CppItemParseUtil::parseAccessModifier(keyword);
 			if (accessModifier != CppAccessModifier::UNKNOWN) {
 				elementIter.moveToNext();
 				if (!elementIter.isValid() || elementIter.element.ch != ':') elementIter.throwParseException("Expected ':' after public/protected/private access modifier.");
 				elementIter.moveToNext();
 				//currentAccessModifier = accessModifier;
 			}
-			else if (text == "class" || text == "struct" || text == "enum" || text == "typedef") {
+			else if (keyword == CppKeyword::CLASS || keyword == CppKeyword::STRUCT || keyword == CppKeyword::ENUM || keyword == CppKeyword::TYPEDEF) {
 				elementIter.moveToNext();
 				// Skip the unsupported nested class declaration.
 				elementIter.findElementAndGetSourceCodeBeforeIt(true, [&] { return elementIter.element.ch == ';'; });
 			}
-			else if (text == exportKeyword || text == exportKeywordWithParameters) {
+			else if (keyword == CppKeyword::EXPORT || keyword == CppKeyword::EXPORT_WITH_PARAMETERS) {
 				elementIter.throwParseException("Export keyword not supported inside a data struct.");
 			}
 			else {
@@ -400,7 +401,7 @@ void CppFileParser::parseStructBody(CppElementIterator &elementIter, CppClass *c
 					// Parse the declaration later because some type names that are not known yet might be needed for parsing variable/member/parameter/return types.
 					classDecl->unresolvedMembers.emplace_back();
 					CppUnresolvedMember &member = classDecl->unresolvedMembers.back();
-					member.sourceCode = make_shared<CppSourceCodeBuffer>(declElementRange);
+					member.sourceCode = declElementRange;
 					member.comment = parseCommentLinesAboveDeclaration(declStartElement.getElementStartFileOffset());
 				}
 				else {
@@ -432,7 +433,7 @@ void CppFileParser::parseEnumBody(CppElementIterator &elementIter, CppClass *cla
 		field.comment = parseCommentLinesAboveDeclaration(elementIter.getElementStartFileOffset());
 		field.sourceLocation = elementIter.getSourceLocation();
 		if (elementIter.element.type != CppElementType::IDENTIFIER) elementIter.throwParseException("Expected enum field name");
-		field.name = elementIter.element.text;
+		field.name = elementIter.element.text.toString();
 		elementIter.moveToNext();
 		LOG_DEBUG(sb() << "Parsing enum field: " << field.name);
 
@@ -453,7 +454,7 @@ void CppFileParser::parseEnumBody(CppElementIterator &elementIter, CppClass *cla
 					elementIter.moveToNextAndSkipSubElements();
 				}
 
-				field.value = string((const char *)content.getBuffer() + valueStartOffset, valueEndOffset - valueStartOffset);
+				field.value = string((const char *)content->getData() + valueStartOffset, valueEndOffset - valueStartOffset);
 			}
 			else if (elementIter.element.ch == ',') {
 				elementIter.moveToNext();
@@ -470,7 +471,7 @@ void CppFileParser::parseEnumBody(CppElementIterator &elementIter, CppClass *cla
 	}
 }
 
-void CppFileParser::parseExportDeclaration(CppElementIterator &elementIter, const string &namespacePrefix, CppClass *enclosingClassIfExists, shared_ptr<CppExportParameters> exportParameters, bool insideUnexportedClass) {
+void CppFileParser::parseExportDeclaration(CppElementIterator &elementIter, const string &namespacePrefix, CppClass *enclosingClassIfExists, CppExportParameters *exportParameters, bool insideUnexportedClass) {
 	CppElementIndex startIndex = elementIter.element.startIndex;
 
 	if (tryParseClass(elementIter, namespacePrefix, enclosingClassIfExists, exportParameters)) {
@@ -487,8 +488,8 @@ void CppFileParser::parseExportDeclaration(CppElementIterator &elementIter, cons
 	}
 
 	// Parse the declaration later because some type names that are not known yet might be needed for parsing variable/member/parameter/return types.
-	shared_ptr<CppUnresolvedFunction> func = make_shared<CppUnresolvedFunction>();
-	func->sourceCode = make_shared<CppSourceCodeBuffer>(functionDeclRange);
+	CppUnresolvedFunction *func = parsedFile->arena.create<CppUnresolvedFunction>();
+	func->sourceCode = functionDeclRange;
 	func->namespacePrefix = namespacePrefix;
 	func->enclosingClassIfExists = enclosingClassIfExists;
 	func->comment = parseCommentLinesAboveDeclaration(functionDeclStartOffset);
@@ -509,45 +510,46 @@ void CppFileParser::scanForExportDeclarationsSub(CppElementIterator &elementIter
 		bool currentKeywordIsUsing = false;
 
 		if (elementIter.element.type == CppElementType::IDENTIFIER) {
-			bool isExportKeyword = elementIter.element.text == exportKeyword;
-			bool isExportKeywordWithParameters = elementIter.element.text == exportKeywordWithParameters;
+			bool isExportKeyword = elementIter.element.keyword == CppKeyword::EXPORT;
+			bool isExportKeywordWithParameters = elementIter.element.keyword == CppKeyword::EXPORT_WITH_PARAMETERS;
 			if (isExportKeyword || isExportKeywordWithParameters) {
 				LOG_DEBUG(sb() << "Found export keyword at: " << elementIter.getSourceLocation().toString());
 				if (!file->isHeaderFile) elementIter.throwParseException(sb() << config->programName << " supports exporting declarations only from header files, not from source files.");
 				elementIter.moveToNext();
 
-				shared_ptr<CppExportParameters> exportParameters = make_shared<CppExportParameters>();
+				CppExportParameters *exportParameters = nullptr;
 				if (isExportKeywordWithParameters) {
 					exportParameters = parseExportParameters(elementIter);
 				}
 				else {
+					exportParameters = parsedFile->arena.create<CppExportParameters>();
 					if (elementIter.isValid() && elementIter.element.ch == '(') elementIter.throwParseException(sb() << "Export keyword " << config->exportKeyword << " does not support parameters (use " << config->exportKeywordWithParameters << " instead if you intended to give parameters)");
 				}
 
 				if (!elementIter.isValid()) elementIter.throwParseException("Expected function/class declaration to export");
 				parseExportDeclaration(elementIter, namespacePrefix, enclosingClassIfExists, exportParameters, insideUnexportedClass);
 			}
-			else if (elementIter.element.text == "class" || elementIter.element.text == "struct") {
+			else if (elementIter.element.keyword == CppKeyword::CLASS || elementIter.element.keyword == CppKeyword::STRUCT) {
 				unexportedClassDeclarationWithinCurrentStatement = true;
 			}
 			else if (elementIter.element.ch == ';') {
 				unexportedClassDeclarationWithinCurrentStatement = false;
 			}
-			else if (elementIter.element.text == "using") {
+			else if (elementIter.element.keyword == CppKeyword::USING) {
 				currentKeywordIsUsing = true;
 			}
-			else if (elementIter.element.text == "namespace") {
+			else if (elementIter.element.keyword == CppKeyword::NAMESPACE) {
 				// Check if this is a namespace declaration (and not a "using namespace" declaration).
 				if (!previousKeywordWasUsing) {
 					elementIter.moveToNext();
 					if (!elementIter.isValid()) elementIter.throwParseException("Expected namespace name");
 					if (elementIter.element.type == CppElementType::IDENTIFIER) { // If not a text element, could be an unnamed namespace, which is ignored.
-						string name = elementIter.element.text;
+						string name = elementIter.element.text.toString();
 						elementIter.moveToNext();
 
 						if (!elementIter.isValid()) elementIter.throwParseException("Expected namespace block");
 						if (elementIter.element.ch == '{') {
-							int oldBlockDepthLimit = elementIter.enterBlockAndGetOldLimit();
+							int oldBlockDepthLimit = elementIter.enterBlockAndTrySkipContentsAndGetOldLimit(findNextPossibleExportKeywordPos(elementIter));
 							scanForExportDeclarationsSub(elementIter, namespacePrefix + name + "::", enclosingClassIfExists, insideUnexportedClass);
 							elementIter.exitBlock(oldBlockDepthLimit, '}', true);
 						}
@@ -556,7 +558,8 @@ void CppFileParser::scanForExportDeclarationsSub(CppElementIterator &elementIter
 			}
 		}
 		else if (elementIter.element.ch == '{') {
-			int oldBlockDepthLimit = elementIter.enterBlockAndGetOldLimit();
+			// Blocks without export keywords (e.g. function bodies) are skipped without tokenizing them.
+			int oldBlockDepthLimit = elementIter.enterBlockAndTrySkipContentsAndGetOldLimit(findNextPossibleExportKeywordPos(elementIter));
 			scanForExportDeclarationsSub(elementIter, namespacePrefix, enclosingClassIfExists, insideUnexportedClass | unexportedClassDeclarationWithinCurrentStatement);
 			elementIter.exitBlock(oldBlockDepthLimit, '}', true);
 			unexportedClassDeclarationWithinCurrentStatement = false;
@@ -575,62 +578,143 @@ void CppFileParser::scanForExportDeclarations(const CppSourceCodeView &elements,
 	scanForExportDeclarationsSub(elementIter, namespacePrefix, enclosingClassIfExists, insideUnexportedClass);
 }
 
-bool CppFileParser::quickScanForPossibleExportKeyword() {
+int64_t CppFileParser::getEndOffsetOfUnresolvedSourceCode() {
+	int64_t result = 0;
+	auto addSourceCode = [&](const CppSourceCodeView &sourceCode) {
+		result = max(result, sourceCode.startFileOffset + sourceCode.dataSize);
+	};
+
+	for (CppUnresolvedFunction *func : parsedFile->unresolvedFunctions) {
+		addSourceCode(func->sourceCode);
+	}
+	for (CppClass *clazz : parsedFile->classes) {
+		for (const CppUnresolvedMember &member : clazz->unresolvedMembers) {
+			addSourceCode(member.sourceCode);
+		}
+	}
+	return result;
+}
+
+void CppFileParser::storeUnresolvedSourceCode() {
+	vector<CppSourceCodeView *> sourceCodes;
+	for (CppUnresolvedFunction *func : parsedFile->unresolvedFunctions) {
+		sourceCodes.push_back(&func->sourceCode);
+	}
+	for (CppClass *clazz : parsedFile->classes) {
+		for (CppUnresolvedMember &member : clazz->unresolvedMembers) {
+			sourceCodes.push_back(&member.sourceCode);
+		}
+	}
+	if (sourceCodes.empty()) return;
+
+	if (config->keepSourceFileContentInMemory) {
+		parsedFile->sourceCodeStorage = content;
+		return;
+	}
+
+	// Copy the declarations into one buffer instead of allocating memory separately for each of them, so that the file content can be released.
+	int64_t totalSize = 0;
+	for (CppSourceCodeView *sourceCode : sourceCodes) {
+		totalSize += sourceCode->dataSize;
+	}
+	shared_ptr<ByteBuffer> buffer = make_shared<ByteBuffer>(totalSize);
+	for (CppSourceCodeView *sourceCode : sourceCodes) {
+		buffer->putBytes(sourceCode->data, sourceCode->dataSize);
+	}
+	int64_t offset = 0;
+	for (CppSourceCodeView *sourceCode : sourceCodes) {
+		sourceCode->data = buffer->getBuffer() + offset;
+		offset += sourceCode->dataSize;
+	}
+	parsedFile->sourceCodeStorage = buffer;
+}
+
+int64_t CppFileParser::findPossibleExportKeyword(int64_t startOffset) {
 	// First check that the parameterized export keyword has the regular export keyword as a prefix, because otherwise would have to search with both.
-	string keyword = config->exportKeyword;
+	const string &keyword = config->exportKeyword;
 	if (keyword.empty()) EXC("Export keyword cannot be empty, check configuration.");
 
 	if (!boost::starts_with(config->exportKeywordWithParameters, keyword)) {
 		EXC(sb() << "Parameterized export keyword " << config->exportKeywordWithParameters << " should have the regular export keyword " << config->exportKeyword << " as a prefix");
 	}
 
-	char firstChar = keyword.at(0);
-	const char *data = (const char *)content.getBuffer();
-	int64_t searchLength = content.getPosition() - (int64_t)keyword.size() + 1;
-	for (int64_t i = 0; i < searchLength; i++) {
-		if (data[i] == firstChar) {
-			if (memcmp(data + i, keyword.data(), keyword.size()) == 0) {
-				return true;
-			}
-		}
+	return findByteSequence(content->getData(), content->getSize(), keyword.data(), (int64_t)keyword.size(), startOffset);
+}
+
+int64_t CppFileParser::findNextPossibleExportKeywordPos(CppElementIterator &elementIter) {
+	// The iterator usually moves forward, so the previous search result can be used until the iterator passes it.
+	int64_t offset = elementIter.getElementEndFileOffset();
+	if (offset < possibleExportKeywordSearchStartOffset || (nextPossibleExportKeywordOffset >= 0 && nextPossibleExportKeywordOffset < offset)) {
+		possibleExportKeywordSearchStartOffset = offset;
+		nextPossibleExportKeywordOffset = findPossibleExportKeyword(offset);
 	}
-	return false;
+
+	CppSourceCodeView *sourceCode = elementIter.getSourceCode();
+	if (nextPossibleExportKeywordOffset < 0) return sourceCode->dataSize;
+	return nextPossibleExportKeywordOffset - sourceCode->startFileOffset;
 }
 
 void CppFileParser::parseFileSub() {
 	LOG_DEBUG(sb() << "Parsing source file: " << file->getPath());
 	StopWatch stopWatch = app->createStopWatchForPerformanceMeasurement();
 
-	content.setPosition(0);
-	loadTextFileAsUtf8(&content, Path(file->getPath()));
+	if (parseCacheIfUsed && parseCacheIfUsed->tryRestoreUnmodifiedFile(parsedFile)) {
+		stopWatch.mark("parseFile / restore from cache");
+		return;
+	}
+
+	// The content is mapped only while this file is being parsed, unless it is kept in memory until linking, or files are expected to be edited
+	// while they are being processed (watch mode). In those cases it is read into memory, because reading a mapped file that has been truncated would crash.
+	content->load(Path(file->getPath()), config->keepSourceFileContentInMemory || config->watchMode);
 
 	stopWatch.mark("parseFile / load text file");
 
-	bool mayHaveExportKeywords = quickScanForPossibleExportKeyword();
+	if (parseCacheIfUsed) {
+		parsedFile->contentHash = calculateHash128(content->getData(), content->getSize());
+		if (parseCacheIfUsed->tryRestoreFileByContentHash(parsedFile)) {
+			stopWatch.mark("parseFile / restore from cache");
+			return;
+		}
+		stopWatch.mark("parseFile / content hash");
+	}
+
+	firstPossibleExportKeywordOffset = findPossibleExportKeyword(0);
+	nextPossibleExportKeywordOffset = firstPossibleExportKeywordOffset;
 
 	stopWatch.mark("parseFile / quick file check");
 
-	if (mayHaveExportKeywords) {
+	if (firstPossibleExportKeywordOffset >= 0) {
 		file->lineAndColumnNumberMap = make_shared<LineAndColumnNumberMap>();
-		file->lineAndColumnNumberMap->build((const char *)content.getBuffer(), content.getPosition());
+		file->lineAndColumnNumberMap->build((const char *)content->getData(), content->getSize());
 		stopWatch.mark("parseFile / line numbers and line-break counts");
 
 		parsedFile->errorList.runWithExceptionCheck([&]() {
-			CppSourceCodeView sourceCode(content.getBuffer(), content.getPosition(), 0, file);
+			CppSourceCodeView sourceCode(content->getData(), content->getSize(), 0, file);
 			scanForExportDeclarations(sourceCode, "", nullptr, false);
 		});
 		stopWatch.mark("parseFile / parse");
+
+		// The content is not available after parsing, so index the lines that may still be needed for source locations when the declarations are resolved.
+		file->lineAndColumnNumberMap->releaseData(getEndOffsetOfUnresolvedSourceCode());
+		stopWatch.mark("parseFile / line numbers and line-break counts");
+
+		storeUnresolvedSourceCode();
+		stopWatch.mark("parseFile / store unresolved source code");
+	}
+
+	if (parseCacheIfUsed && !parsedFile->errorList.hasErrors()) {
+		parseCacheIfUsed->storeParseResult(parsedFile);
+		stopWatch.mark("parseFile / store in cache");
 	}
 }
 
-void CppFileParser::parseFile(CppParsedFile *parsedFile, Config *config) {
+void CppFileParser::parseFile(CppParsedFile *parsedFile, Config *config, CppParseCache *parseCacheIfUsed) {
 	CppFileParser p;
 	p.config = config;
-	p.exportKeyword = config->exportKeyword;
-	p.exportKeywordWithParameters = config->exportKeywordWithParameters;
 	p.file = parsedFile->file.get();
 	p.commentMap = make_shared<CppCommentMap>();
 	p.parsedFile = parsedFile;
+	p.parseCacheIfUsed = parseCacheIfUsed;
 	p.parseFileSub();
 }
 
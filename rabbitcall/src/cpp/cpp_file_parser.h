@@ -1,10 +1,21 @@
 #pragma once
 
+class CppParseCache;
+
 class CppParsedFile {
 public:
 	shared_ptr<CppFile> file;
-	vector<shared_ptr<CppUnresolvedFunction>> unresolvedFunctions;
-	vector<shared_ptr<CppClass>> classes;
+	vector<CppUnresolvedFunction *> unresolvedFunctions;
+	vector<CppClass *> classes;
+	Hash128 contentHash; // Calculated only if the parse cache is used.
+
+	// The classes, functions and comments parsed from this file are allocated here by the parse task and moved to the project arena when the
+	// parse result is applied to the project.
+	Arena arena;
+
+	// Owns the memory that the source code of unresolved functions and members points to: either the whole file content,
+	// a buffer containing only the declarations, or the parse result restored from cache.
+	shared_ptr<void> sourceCodeStorage;
 	ErrorList errorList;
 
 	explicit CppParsedFile(const shared_ptr<CppFile> &file);
@@ -23,17 +34,21 @@ class CppFileParser {
 	CppFile *file = nullptr;
 	shared_ptr<CppCommentMap> commentMap;
 	CppParsedFile *parsedFile = nullptr;
-	ByteBuffer content;
-	string exportKeyword;
-	string exportKeywordWithParameters;
+	CppParseCache *parseCacheIfUsed = nullptr;
+	shared_ptr<Utf8TextFileContent> content = make_shared<Utf8TextFileContent>(); // Shared with the parsed file if the content is kept in memory.
+	// No export declarations can start before this offset, but parsing still starts from the beginning of the file to keep track of namespaces and blocks.
+	int64_t firstPossibleExportKeywordOffset = -1;
+	// The result of the latest search for the next possible export keyword, which allows skipping blocks that don't contain any.
+	int64_t possibleExportKeywordSearchStartOffset = 0;
+	int64_t nextPossibleExportKeywordOffset = -1;
 
 	// Parses parameters in an export keyword (FXP).
-	shared_ptr<CppExportParameters> parseExportParameters(CppElementIterator &elementIter);
+	CppExportParameters * parseExportParameters(CppElementIterator &elementIter);
 
 	string getLineText(int64_t lineNumber);
 
 	bool isLineAcceptedBetweenCommentAndDeclaration(int64_t lineNumber);
-	shared_ptr<CppComment> parseCommentLinesAboveDeclaration(int64_t declarationOffset);
+	CppComment * parseCommentLinesAboveDeclaration(int64_t declarationOffset);
 
 	void parseSuperclassListElement(CppElementIterator &elementIter, CppAccessModifier defaultAccessModifier, const function<void(const CppSuperclassRef &)> &resultCallback);
 	void parseSuperclassList(CppElementIterator &elementIter, CppAccessModifier defaultAccessModifier, const function<void(const CppSuperclassRef &)> &resultCallback);
@@ -42,23 +57,31 @@ class CppFileParser {
 	// is declared in another source file that has not been processed yet (because the parser does not process #include files first in the same way as a normal C++ compiler).
 	CppSourceCodeView extractFunctionOrVariableDeclaration(CppElementIterator &elementIter);
 
-	bool tryParseClass(CppElementIterator &elementIter, const string &namespacePrefix, CppClass *enclosingClassIfExists, shared_ptr<CppExportParameters> exportParameters);
+	bool tryParseClass(CppElementIterator &elementIter, const string &namespacePrefix, CppClass *enclosingClassIfExists, CppExportParameters *exportParameters);
 	void parseStructBody(CppElementIterator &elementIter, CppClass *classDecl);
 	void parseEnumBody(CppElementIterator &elementIter, CppClass *classDecl);
 
 	// Tries to parse a class/function export declaration after an export keyword (FXP).
-	void parseExportDeclaration(CppElementIterator &elementIter, const string &namespacePrefix, CppClass *enclosingClassIfExists, shared_ptr<CppExportParameters> exportParameters, bool insideUnexportedClass);
+	void parseExportDeclaration(CppElementIterator &elementIter, const string &namespacePrefix, CppClass *enclosingClassIfExists, CppExportParameters *exportParameters, bool insideUnexportedClass);
 
 	// Scans for export keywords (FXP) in source code and identifies classes/functions to export.
 	void scanForExportDeclarationsSub(CppElementIterator &elementIter, const string &namespacePrefix, CppClass *enclosingClassIfExists, bool insideUnexportedClass);
 	void scanForExportDeclarations(const CppSourceCodeView &elements, const string &namespacePrefix, CppClass *enclosingClassIfExists, bool insideUnexportedClass);
 
-	// Quickly scans if the file could even possibly contain export keywords before parsing the file fully.
-	bool quickScanForPossibleExportKeyword();
+	// Returns the end of the last source code range that is stored in the parse results for resolving later.
+	int64_t getEndOffsetOfUnresolvedSourceCode();
+	// Makes the source code of unresolved functions and members stay available after the parser has finished.
+	void storeUnresolvedSourceCode();
+
+	// Quickly scans if the file could even possibly contain export keywords (at or after the given offset) before parsing the file fully.
+	// Returns the offset of the first possible export keyword, or -1 if there are none.
+	int64_t findPossibleExportKeyword(int64_t startOffset);
+	// Returns the position (relative to the iterator's source code) of the next possible export keyword after the current element, or the end of the source code.
+	int64_t findNextPossibleExportKeywordPos(CppElementIterator &elementIter);
 
 	void parseFileSub();
 
 public:
-	static void parseFile(CppParsedFile *parsedFile, Config *config);
+	static void parseFile(CppParsedFile *parsedFile, Config *config, CppParseCache *parseCacheIfUsed);
 };
 
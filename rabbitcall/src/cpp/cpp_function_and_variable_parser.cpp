@@ -1,15 +1,15 @@
 #include "pch.h"
 
-CppFuncVarParser::CppFuncVarParser(Config *config, TypeMap *typeMap)
-	: config(config), typeMap(typeMap) {
+CppFuncVarParser::CppFuncVarParser(Config *config, TypeMap *typeMap, Arena *arena)
+	: config(config), typeMap(typeMap), arena(arena) {
 }
 
-shared_ptr<CppFuncVar> CppFuncVarParser::parseLambdaFunctionType(CppElementIterator &elementIter) {
+CppFuncVar * CppFuncVarParser::parseLambdaFunctionType(CppElementIterator &elementIter) {
 	if (!elementIter.isValid() || elementIter.element.ch != '<') elementIter.throwParseException("Expected '<' for function type");
 	elementIter.moveToNext();
 
 	// Parse return value type.
-	shared_ptr<CppFuncVar> result = parseVariableDeclaration(elementIter, false, nullptr).decl;
+	CppFuncVar *result = parseVariableDeclaration(elementIter, false, nullptr).decl;
 	if (result->isLambdaFunction) throw ParseException(result->sourceLocation, "Lambda function as a return value of a lambda function is not supported");
 	result->isLambdaFunction = true;
 
@@ -33,7 +33,7 @@ shared_ptr<CppFuncVar> CppFuncVarParser::parseLambdaFunctionType(CppElementItera
 }
 
 TypeMapping * CppFuncVarParser::tryParsePlainVariableType(CppElementIterator &elementIter) {
-	TypeMappingTrieNode *node = typeMap->getTypeMappingRootNodeAndCheckAllTypesAvailable();
+	int32_t nodeId = typeMap->getTypeMappingRootNodeIdAndCheckAllTypesAvailable();
 	TypeMapping *bestType = nullptr;
 	CppElementIndex bestTypeEndIndexOrRangeStartIndex = elementIter.element.startIndex;
 
@@ -50,15 +50,15 @@ TypeMapping * CppFuncVarParser::tryParsePlainVariableType(CppElementIterator &el
 		// Try to append the current identifier to the name and move to the corresponding node in the trie structure.
 		// If a node is not found, then it's not possible that the name would become valid after the current identifier
 		// and possibly more identifiers are appended.
-		node = node->getSubNodeByNameIfExists(name);
-		if (!node) break;
+		nodeId = typeMap->getSubNodeIdIfExists(nodeId, name);
+		if (nodeId == TypeMap::invalidTrieNodeId) break;
 
-		if (node->isTypeAmbiguous()) elementIter.getSourceCode()->throwParseExceptionByRelativePos(partStartIndex.pos, sb() << "Ambiguous type: " << name);
+		if (typeMap->isNodeTypeAmbiguous(nodeId)) elementIter.getSourceCode()->throwParseExceptionByRelativePos(partStartIndex.pos, sb() << "Ambiguous type: " << name);
 
 		// Check if the current name combination is valid and if it is, save it as the best candidate so far.
 		// The longest valid name will become the result (e.g. "signed long long" instead of "signed long").
 		// Note that it's possible that the current name is not valid now, but becomes valid after more parts are appended.
-		TypeMapping *type = node->getTypeIfUnique();
+		TypeMapping *type = typeMap->getNodeTypeIfUnique(nodeId);
 		if (type) {
 			bestType = type;
 			bestTypeEndIndexOrRangeStartIndex = elementIter.element.startIndex;
@@ -71,8 +71,8 @@ TypeMapping * CppFuncVarParser::tryParsePlainVariableType(CppElementIterator &el
 	return bestType; // Null if not found.
 }
 
-CppFuncVarParser::ParseVariableResult CppFuncVarParser::parseVariableDeclaration(CppElementIterator &elementIter, bool shouldParseVariableName, shared_ptr<CppFuncVar> *baseTypePtrIfVariableList) {
-	shared_ptr<CppFuncVar> variableDecl;
+CppFuncVarParser::ParseVariableResult CppFuncVarParser::parseVariableDeclaration(CppElementIterator &elementIter, bool shouldParseVariableName, CppFuncVar **baseTypePtrIfVariableList) {
+	CppFuncVar *variableDecl = nullptr;
 	CppElementIndex startIndex = elementIter.element.startIndex;
 	int64_t startFileOffset = elementIter.getElementStartFileOffset();
 	bool isStatic = false;
@@ -80,15 +80,18 @@ CppFuncVarParser::ParseVariableResult CppFuncVarParser::parseVariableDeclaration
 	int64_t pointerDepth = 0;
 	int64_t referenceDepth = 0;
 	int64_t explicitAlignment = 0;
+	vector<CppCvQualifiers> cvQualifiersByPointerLevel;
 	CppElementIndex variableNameElementIndex;
 	CppElementIndex arraySizeElementIndex;
 
 	// If this is variable in a comma-separated list of variables, use the previously parsed type from the first variable.
 	bool isFirstVariableInList = true;
 	if (baseTypePtrIfVariableList && *baseTypePtrIfVariableList) {
-		variableDecl = make_shared<CppFuncVar>();
+		variableDecl = arena->create<CppFuncVar>();
 		*variableDecl = **baseTypePtrIfVariableList; // Take a copy of the base type so that the base type can be used for later variables.
 		isFirstVariableInList = false;
+		// The qualifiers of the type itself are shared by the variables in the list, but pointer levels are per variable.
+		if (!variableDecl->cvQualifiersByPointerLevel.empty()) cvQualifiersByPointerLevel.push_back(variableDecl->cvQualifiersByPointerLevel.front());
 	}
 
 	while (elementIter.isValid()) {
@@ -128,7 +131,7 @@ CppFuncVarParser::ParseVariableResult CppFuncVarParser::parseVariableDeclaration
 			break;
 		}
 
-		if (elementIter.element.text == "alignas") {
+		if (elementIter.element.keyword == CppKeyword::ALIGNAS) {
 			elementIter.moveToNext();
 			explicitAlignment = max(explicitAlignment, CppItemParseUtil::parseAlignasParameter(elementIter));
 		}
@@ -143,7 +146,7 @@ CppFuncVarParser::ParseVariableResult CppFuncVarParser::parseVariableDeclaration
 						variableDecl = parseLambdaFunctionType(elementIter);
 					}
 					else {
-						variableDecl = make_shared<CppFuncVar>();
+						variableDecl = arena->create<CppFuncVar>();
 						variableDecl->type = type;
 					}
 				}
@@ -153,9 +156,17 @@ CppFuncVarParser::ParseVariableResult CppFuncVarParser::parseVariableDeclaration
 				bool wasCurrentElementKnownIdentifier = false;
 
 				// The current element was not the beginning of a variable type => check if it is a known keyword.
+				if (elementIter.element.keyword == CppKeyword::CONST || elementIter.element.keyword == CppKeyword::VOLATILE) {
+					// Qualifies the type itself if before any '*' chars (e.g. "const int *" or "int const *"), otherwise the preceding pointer level.
+					size_t level = variableDecl ? (size_t)pointerDepth : 0;
+					if (cvQualifiersByPointerLevel.size() <= level) cvQualifiersByPointerLevel.resize(level + 1);
+					if (elementIter.element.keyword == CppKeyword::CONST) cvQualifiersByPointerLevel[level].isConst = true;
+					else cvQualifiersByPointerLevel[level].isVolatile = true;
+					wasCurrentElementKnownIdentifier = true;
+				}
 				if (isFirstVariableInList) { // Some keywords can only appear with the first variable.
 					if (elementIter.element.type == CppElementType::IDENTIFIER) {
-						if (elementIter.element.text == "static") {
+						if (elementIter.element.keyword == CppKeyword::STATIC) {
 							isStatic = true; // Static can appear before or after the variable type, but only with the first variable in a list.
 							wasCurrentElementKnownIdentifier = true;
 						}
@@ -164,7 +175,7 @@ CppFuncVarParser::ParseVariableResult CppFuncVarParser::parseVariableDeclaration
 
 				if (variableDecl) { // Check if variable type already found.
 					// Check for pointer '*' and reference '&' chars if the variable type has already been found.
-					// There can be "const" keywords between the '*' and '&' chars.
+					// There can be "const" keywords between the '*' and '&' chars (handled above).
 					if (elementIter.element.ch == '&') {
 						if (pointerDepth > 0) elementIter.throwParseException("Cannot have a pointer to a reference.");
 						referenceDepth++;
@@ -199,13 +210,13 @@ CppFuncVarParser::ParseVariableResult CppFuncVarParser::parseVariableDeclaration
 
 	if (baseTypePtrIfVariableList && doesListContinueAfterThisVariable) {
 		// Store the variable type from the first variable in a list for the subsequent variables that share the same type.
-		*baseTypePtrIfVariableList = make_shared<CppFuncVar>();
+		*baseTypePtrIfVariableList = arena->create<CppFuncVar>();
 		**baseTypePtrIfVariableList = *variableDecl;
 	}
 
 	if (shouldParseVariableName && variableNameElementIndex.isValid()) {
 		CppElementIterator variableNameElement(*elementIter.getSourceCode(), variableNameElementIndex, CPP_INVALID_BLOCK_DEPTH, nullptr);
-		variableDecl->declarationName = variableNameElement.element.text;
+		variableDecl->declarationName = variableNameElement.element.text.toString();
 	}
 
 	int64_t arraySize = 0;
@@ -224,6 +235,8 @@ CppFuncVarParser::ParseVariableResult CppFuncVarParser::parseVariableDeclaration
 	variableDecl->pointerDepth = (int)pointerDepth;
 	variableDecl->referenceDepth = (int)referenceDepth;
 	variableDecl->explicitAlignment = (int)explicitAlignment;
+	while (!cvQualifiersByPointerLevel.empty() && cvQualifiersByPointerLevel.back().isEmpty()) cvQualifiersByPointerLevel.pop_back();
+	variableDecl->cvQualifiersByPointerLevel = cvQualifiersByPointerLevel;
 
 	if (variableDecl->isLambdaFunction && variableDecl->pointerDepth > 0) elementIter.getSourceCode()->throwParseExceptionByRelativePos(startIndex.pos, "Pointer to std::function object not supported (use \"const std::function<void()> &\")");
 
@@ -253,12 +266,12 @@ CppFuncVarParser::FunctionIdentifyResult CppFuncVarParser::tryIdentifyFunction(c
 				paramElementIndex = elementIter.element.startIndex;
 				nextEqualSignCouldBePartOfOperatorOverload = false;
 			}
-			else if (elementIter.element.text == "alignas") {
+			else if (elementIter.element.keyword == CppKeyword::ALIGNAS) {
 				// Avoid misidentifying the parentheses after an "alignas" keyword as a function parameter list.
 				elementIter.moveToNext();
 				// The parentheses will be skipped below.
 			}
-			else if (elementIter.element.text == "operator") {
+			else if (elementIter.element.keyword == CppKeyword::OPERATOR) {
 				nextEqualSignCouldBePartOfOperatorOverload = true;
 			}
 			else if (elementIter.element.ch == '=') {
@@ -281,7 +294,7 @@ CppFuncVarParser::FunctionIdentifyResult CppFuncVarParser::tryIdentifyFunction(c
 	return result;
 }
 
-shared_ptr<CppFuncVar> CppFuncVarParser::tryParseFunctionDeclaration(const CppSourceCodeView &elements, const string &namespacePrefix) {
+CppFuncVar * CppFuncVarParser::tryParseFunctionDeclaration(const CppSourceCodeView &elements, const string &namespacePrefix) {
 	FunctionIdentifyResult identifyResult = tryIdentifyFunction(elements);
 	if (!identifyResult.isFunction) {
 		return nullptr;
@@ -294,7 +307,7 @@ shared_ptr<CppFuncVar> CppFuncVarParser::tryParseFunctionDeclaration(const CppSo
 
 	// Parse the return type and name as a "variable".
 	CppElementIterator nameAndReturnTypeIter = CppElementIterator(functionNameAndReturnTypeElements, nullptr);
-	shared_ptr<CppFuncVar> functionDecl = parseVariableDeclaration(nameAndReturnTypeIter, true, nullptr).decl;
+	CppFuncVar *functionDecl = parseVariableDeclaration(nameAndReturnTypeIter, true, nullptr).decl;
 	functionDecl->namespacePrefixIfGlobal = namespacePrefix;
 	if (functionDecl->arraySize > 0) elements.throwParseExceptionAtStart("Arrays not supported for function return values");
 	if (functionDecl->declarationName.empty()) paramIter.throwParseException("Expected function name before parameter list");
@@ -322,9 +335,15 @@ shared_ptr<CppFuncVar> CppFuncVarParser::tryParseFunctionDeclaration(const CppSo
 			break;
 		}
 
-		if (paramIter.element.text == "noexcept") {
+		if (paramIter.element.keyword == CppKeyword::NOEXCEPT) {
 			functionDecl->isNoexcept = true;
 		}
+		else if (paramIter.element.keyword == CppKeyword::CONST) {
+			functionDecl->functionCvQualifiers.isConst = true;
+		}
+		else if (paramIter.element.keyword == CppKeyword::VOLATILE) {
+			functionDecl->functionCvQualifiers.isVolatile = true;
+		}
 
 		paramIter.moveToNextAndSkipSubElements();
 	}
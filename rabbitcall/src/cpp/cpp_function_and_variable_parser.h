@@ -5,10 +5,11 @@ class CppFuncVarParser {
 
 	Config *config = nullptr;
 	TypeMap *typeMap = nullptr;
+	Arena *arena = nullptr; // The parsed declarations are allocated here.
 	
 public:
 	struct ParseVariableResult {
-		shared_ptr<CppFuncVar> decl;
+		CppFuncVar *decl = nullptr;
 		bool doesListContinue = false;
 	};
 
@@ -18,19 +19,19 @@ public:
 		bool isFunction = false;
 	};
 	
-	explicit CppFuncVarParser(Config *config, TypeMap *typeMap);
+	explicit CppFuncVarParser(Config *config, TypeMap *typeMap, Arena *arena);
 
 	// Parses the type of an std::function, e.g. "<void(int, double)>".
-	shared_ptr<CppFuncVar> parseLambdaFunctionType(CppElementIterator &elementIter);
+	CppFuncVar * parseLambdaFunctionType(CppElementIterator &elementIter);
 
 	// Parses a variable type name without additional keywords, but including qualified and multipart names, e.g. "int", "unsigned int", "string", "std::string".
 	TypeMapping * tryParsePlainVariableType(CppElementIterator &elementIter);
 
 	// Parses a variable declaration, possibly in a list of variables, e.g. "int t", "static int t, **t2[10]", "const std::string &t".
-	ParseVariableResult parseVariableDeclaration(CppElementIterator &elementIter, bool shouldParseVariableName, shared_ptr<CppFuncVar> *baseTypePtrIfVariableList);
+	ParseVariableResult parseVariableDeclaration(CppElementIterator &elementIter, bool shouldParseVariableName, CppFuncVar **baseTypePtrIfVariableList);
 
 	// Checks if the given source code range represents a function.
 	FunctionIdentifyResult tryIdentifyFunction(const CppSourceCodeView &elements);
 
-	shared_ptr<CppFuncVar> tryParseFunctionDeclaration(const CppSourceCodeView &elements, const string &namespacePrefix);
+	CppFuncVar * tryParseFunctionDeclaration(const CppSourceCodeView &elements, const string &namespacePrefix);
 };
\ No newline at end of file
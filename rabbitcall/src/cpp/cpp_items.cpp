@@ -11,7 +11,7 @@ string CppFuncVar::getNamespaceName() const {
 	return boost::ends_with(ns, "::") ? ns.substr(0, ns.size() - 2) : ns;
 }
 
-void CppFuncVar::addFunctionParameterType(shared_ptr<CppFuncVar> v) {
+void CppFuncVar::addFunctionParameterType(CppFuncVar *v) {
 	functionParameters.push_back(v);
 }
 
@@ -37,15 +37,15 @@ CppFuncVar CppFuncVar::getFunctionReturnTypeAndName() const {
 
 CppStructLayout * CppClass::getLayoutOrThrow() const {
 	if (!layout) EXC(sb() << "Layout missing for class/struct: " << typeNames.cppType);
-	return layout.get();
+	return layout;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-CppAccessModifier CppItemParseUtil::parseAccessModifier(const string &text) {
-	if (text == "public") return CppAccessModifier::PUBLIC;
-	if (text == "protected") return CppAccessModifier::PROTECTED;
-	if (text == "private") return CppAccessModifier::PRIVATE;
+CppAccessModifier CppItemParseUtil::parseAccessModifier(CppKeyword keyword) {
+	if (keyword == CppKeyword::PUBLIC) return CppAccessModifier::PUBLIC;
+	if (keyword == CppKeyword::PROTECTED) return CppAccessModifier::PROTECTED;
+	if (keyword == CppKeyword::PRIVATE) return CppAccessModifier::PRIVATE;
 	return CppAccessModifier::UNKNOWN;
 }
 
@@ -77,17 +77,17 @@ string CppItemParseUtil::tryParsePossiblyQualifiedName(CppElementIterator &eleme
 			elementIter = startElement;
 			return "";
 		}
-		result += elementIter.element.text;
+		result += elementIter.element.text.toString();
 		elementIter.moveToNextAndSkipSubElements();
 
-		if (elementIter.element.text == "operator") {
+		if (elementIter.element.keyword == CppKeyword::OPERATOR) {
 			{
 				CppElementIterator nextElementIter = elementIter.getNextAndSkipSubElements();
 				if (nextElementIter.isValid()) {
-					string text = nextElementIter.element.text;
-					if (text == "new" || text == "delete" || text == "co_await") { // Operator new/delete/co_await
+					CppKeyword keyword = nextElementIter.element.keyword;
+					if (keyword == CppKeyword::OPERATOR_NEW || keyword == CppKeyword::OPERATOR_DELETE || keyword == CppKeyword::OPERATOR_CO_AWAIT) { // Operator new/delete/co_await
 						result += " ";
-						result += text;
+						result += nextElementIter.element.text.toString();
 						elementIter = nextElementIter;
 					}
 				}
@@ -129,7 +129,7 @@ unordered_map<string, CppSourceCodeView> CppItemParseUtil::parseCommaSeparatedPa
 		if (!paramIter.isValid()) paramIter.throwParseException("Empty parameter");
 
 		if (paramIter.element.type != CppElementType::IDENTIFIER) paramIter.throwParseException(sb() << "Expected parameter name");
-		string name = paramIter.element.text;
+		string name = paramIter.element.text.toString();
 		if (result.find(name) != result.end()) paramIter.throwParseException(sb() << "Multiple instances of the same parameter: " << name);
 
 		if (!paramIter.moveToNextAndSkipSubElements()) {
@@ -159,11 +159,42 @@ bool CppItemParseUtil::isSameTypeSignature(CppFuncVar *f1, CppFuncVar *f2) {
 	size_t numParameters = f1->functionParameters.size();
 	if (numParameters != f2->functionParameters.size()) return false;
 	for (size_t i = 0; i < numParameters; i++) {
-		if (!isSameTypeSignature(f1->functionParameters[i].get(), f2->functionParameters[i].get())) return false;
+		if (!isSameTypeSignature(f1->functionParameters[i], f2->functionParameters[i])) return false;
 	}
 	return true;
 }
 
+string CppItemParseUtil::getTypeSignature(CppFuncVar *f, bool isFunction) {
+	CHECK_NOT_NULL(f);
+	StringBuilder s;
+	auto getCvQualifiers = [&](const CppCvQualifiers &q) -> const char * {
+		if (q.isConst && q.isVolatile) return "const volatile";
+		if (q.isConst) return "const";
+		if (q.isVolatile) return "volatile";
+		return "";
+	};
+	auto getCvQualifiersOfPointerLevel = [&](int level) -> const char * {
+		if (level >= (int)f->cvQualifiersByPointerLevel.size()) return "";
+		return getCvQualifiers(f->cvQualifiersByPointerLevel[level]);
+	};
+
+	if (f->isStatic) s << "static ";
+	if (*getCvQualifiersOfPointerLevel(0)) s << getCvQualifiersOfPointerLevel(0) << " ";
+	s << (f->type ? f->type->typeNames.cppType : "?");
+	for (int i = 0; i < f->pointerDepth; i++) s << "*" << getCvQualifiersOfPointerLevel(i + 1);
+	for (int i = 0; i < f->referenceDepth; i++) s << "&";
+	if (f->arraySize > 0) s << "[" << f->arraySize << "]";
+	if (isFunction) {
+		s << "(";
+		for (size_t i = 0; i < f->functionParameters.size(); i++) {
+			if (i > 0) s << ",";
+			s << getTypeSignature(f->functionParameters[i], f->functionParameters[i]->isLambdaFunction);
+		}
+		s << ")" << getCvQualifiers(f->functionCvQualifiers);
+	}
+	return s;
+}
+
 bool CppItemParseUtil::tryParseInt64InParenthesis(CppElementIterator &elementIter, char parenthesisType, int64_t *result) {
 	if (!elementIter.isValid() || elementIter.element.ch != parenthesisType) return false;
 	CppSourceCodeView subElements = elementIter.getSubElements();
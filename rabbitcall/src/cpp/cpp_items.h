@@ -45,6 +45,15 @@ struct CppComment {
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+struct CppCvQualifiers {
+	bool isConst = false;
+	bool isVolatile = false;
+
+	bool isEmpty() const { return !isConst && !isVolatile; }
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 // C++ function or variable declaration.
 class CppFuncVar {
 public:
@@ -52,6 +61,8 @@ public:
 	string namespacePrefixIfGlobal;
 	TypeMapping *type = nullptr; // For functions, this is the return value type.
 	int pointerDepth = 0; // How many pointer asterisks there are after the C++ type name.
+	vector<CppCvQualifiers> cvQualifiersByPointerLevel; // Index 0 for the type itself, index n for the n:th pointer level. Unqualified levels at the end are omitted.
+	CppCvQualifiers functionCvQualifiers; // For member functions, e.g. "int getX() const".
 	int referenceDepth = 0;
 	int arraySize = 0; // Zero means not an array.
 	int explicitAlignment = 0;
@@ -59,16 +70,17 @@ public:
 	bool isNoexcept = false;
 	bool isLambdaFunction = false;
 	CppAccessModifier accessModifier = CppAccessModifier::PUBLIC;
-	vector<shared_ptr<CppFuncVar>> functionParameters;
+	vector<CppFuncVar *> functionParameters;
 	unordered_map<string, string> functionEntryPointNameByContext;
-	shared_ptr<CppComment> comment;
+	unordered_map<string, string> callbackWrapperClassNameByContext; // For callback parameters, the name of the generated C++ functor class.
+	CppComment *comment = nullptr;
 	SourceLocation sourceLocation;
 
 	CppFuncVar() {
 	}
 
 	string getNamespaceName() const;
-	void addFunctionParameterType(shared_ptr<CppFuncVar> v);
+	void addFunctionParameterType(CppFuncVar *v);
 	bool isVoid() const;
 	CppFuncVar getFunctionReturnType() const;
 	CppFuncVar getFunctionReturnTypeAndName() const;
@@ -88,11 +100,11 @@ public:
 		int64_t arraySize = 0;
 
 		string name;
-		TypeNamesByLanguage typeNames;
+		TypeMapping *type = nullptr;
 
 		CppAccessModifier accessModifier = CppAccessModifier::PUBLIC;
 
-		shared_ptr<CppComment> comment;
+		CppComment *comment = nullptr;
 		SourceLocation sourceLocation;
 	};
 
@@ -108,7 +120,7 @@ public:
 struct CppEnumField {
 	string name;
 	string value;
-	shared_ptr<CppComment> comment;
+	CppComment *comment = nullptr;
 	SourceLocation sourceLocation;
 };
 
@@ -135,8 +147,9 @@ struct CppSuperclassRef {
 
 struct CppUnresolvedMember {
 	// Contains partially-parsed source code for each member declaration that can be fully resolved only after all input files have been read and types are known.
-	shared_ptr<CppSourceCodeBuffer> sourceCode;
-	shared_ptr<CppComment> comment;
+	// Points to memory owned by the parsed file (see CppParsedFile::sourceCodeStorage).
+	CppSourceCodeView sourceCode;
+	CppComment *comment = nullptr;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -149,15 +162,15 @@ public:
 	int64_t explicitAlignment = 0;
 	bool isClassEnum = false; // "enum class Xyz" instead of just "enum Xyz".
 	bool isPassByValue = false;
-	shared_ptr<TypeMapping> typeMapping;
-	shared_ptr<CppStructLayout> layout;
-	shared_ptr<CppExportParameters> exportParameters;
-	shared_ptr<CppComment> comment;
+	TypeMapping *typeMapping = nullptr;
+	CppStructLayout *layout = nullptr;
+	CppExportParameters *exportParameters = nullptr;
+	CppComment *comment = nullptr;
 	SourceLocation sourceLocation;
 
 	vector<CppUnresolvedMember> unresolvedMembers;
-	vector<shared_ptr<CppFuncVar>> functions;
-	vector<shared_ptr<CppFuncVar>> fields;
+	vector<CppFuncVar *> functions;
+	vector<CppFuncVar *> fields;
 	vector<CppEnumField> enumFields;
 	vector<CppSuperclassRef> superclasses;
 
@@ -175,10 +188,10 @@ public:
 // A function declaration that has been encountered in source code but has not yet been parsed, because not all types in the project are known yet
 // (which may affect parsing because heuristics are used for identifying types in the declaration).
 struct CppUnresolvedFunction {
-	shared_ptr<CppSourceCodeBuffer> sourceCode;
+	CppSourceCodeView sourceCode; // Points to memory owned by the parsed file (see CppParsedFile::sourceCodeStorage).
 	string namespacePrefix;
 	CppClass *enclosingClassIfExists = nullptr;
-	shared_ptr<CppComment> comment;
+	CppComment *comment = nullptr;
 };
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -189,11 +202,32 @@ struct CppStatistics {
 	int64_t numFunctions = 0;
 	int64_t numSourceBytes = 0;
 
+	// Parsing the source files (measured for the whole project).
+	int numParseThreads = 0;
+	int64_t numParseTasks = 0;
+	double parseWallSeconds = 0; // Elapsed time from the start of the first parse task to the end of the last one.
+	double parseTaskSeconds = 0; // Sum of the time spent in the parse tasks.
+	double longestParseTaskSeconds = 0;
+
+	bool linkingSkipped = false; // All partitions were up-to-date, so the classes were not linked and the functions not counted.
+
 	void add(CppStatistics *stats) {
 		numSourceFiles += stats->numSourceFiles;
 		numClasses += stats->numClasses;
 		numFunctions += stats->numFunctions;
 		numSourceBytes += stats->numSourceBytes;
+		numParseThreads = max(numParseThreads, stats->numParseThreads);
+		numParseTasks += stats->numParseTasks;
+		parseWallSeconds += stats->parseWallSeconds;
+		parseTaskSeconds += stats->parseTaskSeconds;
+		longestParseTaskSeconds = max(longestParseTaskSeconds, stats->longestParseTaskSeconds);
+		linkingSkipped = linkingSkipped || stats->linkingSkipped;
+	}
+
+	// Ratio of the work done to the time the threads were available for it (1 = all threads were busy all the time).
+	double getParallelParseEfficiency() const {
+		if (parseWallSeconds <= 0 || numParseThreads <= 0) return 0;
+		return parseTaskSeconds / (parseWallSeconds * numParseThreads);
 	}
 };
 
@@ -201,7 +235,7 @@ struct CppStatistics {
 
 namespace CppItemParseUtil {
 
-	CppAccessModifier parseAccessModifier(const string &text);
+	CppAccessModifier parseAccessModifier(CppKeyword keyword);
 
 	// Tries to read the given characters, which may span multiple elements but must not have spaces in the middle.
 	bool tryParseSpecialChars(CppElementIterator &elementIter, const char *s);
@@ -212,6 +246,9 @@ namespace CppItemParseUtil {
 	unordered_map<string, CppSourceCodeView> parseCommaSeparatedParameterMap(const CppSourceCodeView &elements);
 
 	bool isSameTypeSignature(CppFuncVar *f1, CppFuncVar *f2);
+	// Text representation of the types, e.g. "int(float*,const std::string&)const" for a function. Unlike isSameTypeSignature(), distinguishes
+	// const/volatile qualifiers, so that e.g. const and non-const overloads of a member function have different signatures.
+	string getTypeSignature(CppFuncVar *f, bool isFunction);
 
 	bool tryParseInt64InParenthesis(CppElementIterator &elementIter, char parenthesisType, int64_t *result);
 	int64_t parseAlignasParameter(CppElementIterator &elementIter);
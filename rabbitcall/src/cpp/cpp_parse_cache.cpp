@@ -0,0 +1,379 @@
+#include "pch.h"
+
+
+static const char parseCacheFileMagic[] = "RCPC";
+static const uint64_t parseCacheFormatVersion = 1;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+CppParseCache::CppParseCache(const Path &path, const string &parserSettings)
+	: path(path), parserSettings(parserSettings) {
+}
+
+void CppParseCache::writeComment(ByteBuffer *b, CppComment *comment) {
+	if (!comment) {
+		b->putVlq(0);
+		return;
+	}
+	b->putVlq(comment->lines.size() + 1);
+	for (const string &line : comment->lines) {
+		b->putString(line);
+	}
+}
+
+CppComment * CppParseCache::readComment(ByteBuffer *b, Arena *arena) {
+	uint64_t numLinesPlusOne = b->getVlq();
+	if (numLinesPlusOne == 0) return nullptr;
+	CppComment *comment = arena->create<CppComment>();
+	for (uint64_t i = 1; i < numLinesPlusOne; i++) {
+		comment->lines.push_back(b->getString());
+	}
+	return comment;
+}
+
+void CppParseCache::writeSourceLocation(ByteBuffer *b, const SourceLocation &location) {
+	LineAndColumnNumber lineAndColumn = location.getLineAndColumnNumber();
+	b->putVlq(lineAndColumn.line);
+	b->putVlq(lineAndColumn.column);
+}
+
+SourceLocation CppParseCache::readSourceLocation(ByteBuffer *b, CppFile *file) {
+	int line = (int)b->getVlq();
+	int column = (int)b->getVlq();
+	return SourceLocation(file->path, LineAndColumnNumber(line, column));
+}
+
+void CppParseCache::writeSourceCode(ByteBuffer *b, const CppSourceCodeView &sourceCode) {
+	b->putVlq(sourceCode.startFileOffset);
+	b->putVlq(sourceCode.dataSize);
+	b->putBytes(sourceCode.data, sourceCode.dataSize);
+}
+
+CppSourceCodeView CppParseCache::readSourceCode(ByteBuffer *b, CppFile *file) {
+	int64_t startFileOffset = (int64_t)b->getVlq();
+	int64_t dataSize = (int64_t)b->getVlq();
+	const void *data = b->skipBytes(dataSize);
+	return CppSourceCodeView(data, dataSize, startFileOffset, file);
+}
+
+void CppParseCache::writeClass(ByteBuffer *b, CppClass *clazz) {
+	b->putVlq((uint64_t)clazz->classType);
+	b->putString(clazz->typeNames.cppType);
+	b->putString(clazz->typeNames.csType);
+	b->putString(clazz->typeNames.hlslType);
+	b->putString(clazz->typeNames.glslType);
+	b->putVlq(clazz->explicitAlignment);
+	b->putVlq(clazz->isClassEnum);
+	b->putVlq(clazz->isPassByValue);
+
+	CppExportParameters *p = clazz->exportParameters;
+	b->putVlq(p != nullptr);
+	if (p) {
+		b->putVlq(p->hlslParameters.exportHlsl);
+		b->putVlq(p->hlslParameters.isCBuffer);
+		b->putString(p->hlslParameters.fieldPrefix);
+		b->putString(p->hlslParameters.registerName);
+		b->putVlq(p->glslParameters.exportGlsl);
+		b->putString(p->glslParameters.storage);
+		b->putString(p->glslParameters.instanceName);
+		b->putString(p->glslParameters.fieldPrefix);
+		b->putString(p->glslParameters.binding);
+	}
+
+	writeComment(b, clazz->comment);
+	writeSourceLocation(b, clazz->sourceLocation);
+
+	b->putVlq(clazz->unresolvedMembers.size());
+	for (const CppUnresolvedMember &member : clazz->unresolvedMembers) {
+		writeSourceCode(b, member.sourceCode);
+		writeComment(b, member.comment);
+	}
+
+	b->putVlq(clazz->enumFields.size());
+	for (const CppEnumField &field : clazz->enumFields) {
+		b->putString(field.name);
+		b->putString(field.value);
+		writeComment(b, field.comment);
+		writeSourceLocation(b, field.sourceLocation);
+	}
+
+	b->putVlq(clazz->superclasses.size());
+	for (const CppSuperclassRef &superclass : clazz->superclasses) {
+		b->putString(superclass.partialName);
+		b->putVlq((uint64_t)superclass.accessModifier);
+		writeSourceLocation(b, superclass.sourceLocation);
+	}
+}
+
+CppClass * CppParseCache::readClass(ByteBuffer *b, CppFile *file, Arena *arena) {
+	CppClass *clazz = arena->create<CppClass>();
+	clazz->classType = (CppClassDeclarationType)b->getVlq();
+	clazz->typeNames.cppType = b->getString();
+	clazz->typeNames.csType = b->getString();
+	clazz->typeNames.hlslType = b->getString();
+	clazz->typeNames.glslType = b->getString();
+	clazz->explicitAlignment = (int64_t)b->getVlq();
+	clazz->isClassEnum = b->getVlq() != 0;
+	clazz->isPassByValue = b->getVlq() != 0;
+
+	if (b->getVlq() != 0) {
+		CppExportParameters *p = arena->create<CppExportParameters>();
+		p->hlslParameters.exportHlsl = b->getVlq() != 0;
+		p->hlslParameters.isCBuffer = b->getVlq() != 0;
+		p->hlslParameters.fieldPrefix = b->getString();
+		p->hlslParameters.registerName = b->getString();
+		p->glslParameters.exportGlsl = b->getVlq() != 0;
+		p->glslParameters.storage = b->getString();
+		p->glslParameters.instanceName = b->getString();
+		p->glslParameters.fieldPrefix = b->getString();
+		p->glslParameters.binding = b->getString();
+		clazz->exportParameters = p;
+	}
+
+	clazz->comment = readComment(b, arena);
+	clazz->sourceLocation = readSourceLocation(b, file);
+
+	uint64_t numMembers = b->getVlq();
+	for (uint64_t i = 0; i < numMembers; i++) {
+		clazz->unresolvedMembers.emplace_back();
+		CppUnresolvedMember &member = clazz->unresolvedMembers.back();
+		member.sourceCode = readSourceCode(b, file);
+		member.comment = readComment(b, arena);
+	}
+
+	uint64_t numEnumFields = b->getVlq();
+	for (uint64_t i = 0; i < numEnumFields; i++) {
+		CppEnumField field;
+		field.name = b->getString();
+		field.value = b->getString();
+		field.comment = readComment(b, arena);
+		field.sourceLocation = readSourceLocation(b, file);
+		clazz->enumFields.push_back(field);
+	}
+
+	uint64_t numSuperclasses = b->getVlq();
+	for (uint64_t i = 0; i < numSuperclasses; i++) {
+		CppSuperclassRef superclass;
+		superclass.partialName = b->getString();
+		superclass.accessModifier = (CppAccessModifier)b->getVlq();
+		superclass.sourceLocation = readSourceLocation(b, file);
+		clazz->superclasses.push_back(superclass);
+	}
+
+	return clazz;
+}
+
+void CppParseCache::writeParsedFile(ByteBuffer *b, CppParsedFile *parsedFile) {
+	LineAndColumnNumberMap *lineAndColumnNumberMap = parsedFile->file->lineAndColumnNumberMap.get();
+	b->putVlq(lineAndColumnNumberMap != nullptr);
+	if (lineAndColumnNumberMap) {
+		lineAndColumnNumberMap->writeTo(b);
+	}
+
+	unordered_map<CppClass *, uint64_t> classIndexes;
+	b->putVlq(parsedFile->classes.size());
+	for (uint64_t i = 0; i < parsedFile->classes.size(); i++) {
+		CppClass *clazz = parsedFile->classes.at(i);
+		classIndexes[clazz] = i;
+		writeClass(b, clazz);
+	}
+
+	b->putVlq(parsedFile->unresolvedFunctions.size());
+	for (CppUnresolvedFunction *func : parsedFile->unresolvedFunctions) {
+		writeSourceCode(b, func->sourceCode);
+		b->putString(func->namespacePrefix);
+
+		// The enclosing class is always declared in the same file, so it is stored as an index (plus one, zero meaning no class).
+		uint64_t enclosingClassIndexPlusOne = 0;
+		if (func->enclosingClassIfExists) {
+			auto iter = classIndexes.find(func->enclosingClassIfExists);
+			if (iter == classIndexes.end()) EXC(sb() << "Enclosing class not found in parsed file: " << func->enclosingClassIfExists->typeNames.cppType);
+			enclosingClassIndexPlusOne = iter->second + 1;
+		}
+		b->putVlq(enclosingClassIndexPlusOne);
+
+		writeComment(b, func->comment);
+	}
+}
+
+void CppParseCache::readParsedFile(ByteBuffer *b, CppParsedFile *parsedFile) {
+	CppFile *file = parsedFile->file.get();
+	parsedFile->classes.clear();
+	parsedFile->unresolvedFunctions.clear();
+	file->lineAndColumnNumberMap = nullptr;
+
+	if (b->getVlq() != 0) {
+		file->lineAndColumnNumberMap = make_shared<LineAndColumnNumberMap>();
+		file->lineAndColumnNumberMap->readFrom(b);
+	}
+
+	uint64_t numClasses = b->getVlq();
+	for (uint64_t i = 0; i < numClasses; i++) {
+		parsedFile->classes.push_back(readClass(b, file, &parsedFile->arena));
+	}
+
+	uint64_t numFunctions = b->getVlq();
+	for (uint64_t i = 0; i < numFunctions; i++) {
+		CppUnresolvedFunction *func = parsedFile->arena.create<CppUnresolvedFunction>();
+		func->sourceCode = readSourceCode(b, file);
+		func->namespacePrefix = b->getString();
+		uint64_t enclosingClassIndexPlusOne = b->getVlq();
+		if (enclosingClassIndexPlusOne > 0) {
+			func->enclosingClassIfExists = parsedFile->classes.at(enclosingClassIndexPlusOne - 1);
+		}
+		func->comment = readComment(b, &parsedFile->arena);
+		parsedFile->unresolvedFunctions.push_back(func);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void CppParseCache::load() {
+	StopWatch stopWatch = app->createStopWatchForPerformanceMeasurement();
+	lock_guard<mutex> lockGuard(lock);
+	entriesByPath.clear();
+	modified = false;
+
+	if (path.empty() || !exists(path.path())) {
+		LOG_DEBUG(sb() << "Parse cache does not exist: " << path);
+		return;
+	}
+
+	try {
+		ByteBuffer b;
+		loadBinaryFile(&b, path);
+		b.compact();
+		b.setPosition(0);
+
+		char magic[sizeof(parseCacheFileMagic) - 1];
+		b.getBytes(magic, sizeof(magic));
+		if (memcmp(magic, parseCacheFileMagic, sizeof(magic)) != 0) EXC("Not a parse cache file");
+		if (b.getVlq() != parseCacheFormatVersion || b.getString() != parserSettings) {
+			LOG_DEBUG(sb() << "Parse cache was created with a different version or settings, ignoring it: " << path);
+			return;
+		}
+
+		uint64_t numEntries = b.getVlq();
+		for (uint64_t i = 0; i < numEntries; i++) {
+			string filePath = b.getString();
+			Entry entry;
+			entry.fileSize = b.get<int64_t>();
+			entry.lastModified = b.get<int64_t>();
+			entry.contentHash.low = b.get<uint64_t>();
+			entry.contentHash.high = b.get<uint64_t>();
+			uint64_t dataSize = b.getVlq();
+			entry.data = make_shared<string>((const char *)b.skipBytes(dataSize), dataSize);
+			entriesByPath[filePath] = entry;
+		}
+	}
+	catch (exception &e) {
+		LOG_INFO(sb() << "Ignoring invalid parse cache file (" << e.what() << "): " << path);
+		entriesByPath.clear();
+	}
+
+	stopWatch.mark("parse cache / load");
+}
+
+void CppParseCache::saveIfModified() {
+	StopWatch stopWatch = app->createStopWatchForPerformanceMeasurement();
+	lock_guard<mutex> lockGuard(lock);
+	if (!modified || path.empty()) return;
+
+	// Sort the entries so that the file content is the same regardless of the order in which the files were parsed.
+	map<string, Entry *> sortedEntries;
+	for (auto &entry : entriesByPath) {
+		sortedEntries[entry.first] = &entry.second;
+	}
+
+	ByteBuffer b;
+	b.putBytes(parseCacheFileMagic, sizeof(parseCacheFileMagic) - 1);
+	b.putVlq(parseCacheFormatVersion);
+	b.putString(parserSettings);
+	b.putVlq(sortedEntries.size());
+	for (auto &sortedEntry : sortedEntries) {
+		Entry *entry = sortedEntry.second;
+		b.putString(sortedEntry.first);
+		b.put<int64_t>(entry->fileSize);
+		b.put<int64_t>(entry->lastModified);
+		b.put<uint64_t>(entry->contentHash.low);
+		b.put<uint64_t>(entry->contentHash.high);
+		b.putString(*entry->data);
+	}
+
+	saveBinaryFile(path, b.getBuffer(), b.getPosition());
+	modified = false;
+	LOG_DEBUG(sb() << "Saved parse cache: " << path);
+	stopWatch.mark("parse cache / save");
+}
+
+bool CppParseCache::tryRestore(CppParsedFile *parsedFile, const function<bool(Entry &)> &isEntryValid) {
+	shared_ptr<string> data;
+	{
+		lock_guard<mutex> lockGuard(lock);
+		auto iter = entriesByPath.find(parsedFile->file->getPath());
+		if (iter == entriesByPath.end()) return false;
+		Entry &entry = iter->second;
+		if (!isEntryValid(entry)) return false;
+		entry.usedInCurrentRound = true;
+		parsedFile->contentHash = entry.contentHash;
+		data = entry.data;
+	}
+
+	// The restored source code of unresolved functions and members points to this buffer.
+	shared_ptr<ByteBuffer> b = make_shared<ByteBuffer>(data->size());
+	b->putBytes(data->data(), data->size());
+	b->setPosition(0);
+	readParsedFile(b.get(), parsedFile);
+	parsedFile->sourceCodeStorage = b;
+	LOG_DEBUG(sb() << "Restored parse result from cache: " << parsedFile->file->getPath());
+	return true;
+}
+
+bool CppParseCache::tryRestoreUnmodifiedFile(CppParsedFile *parsedFile) {
+	CppFile *file = parsedFile->file.get();
+	return tryRestore(parsedFile, [&](Entry &entry) {
+		return entry.fileSize == file->fileSize && entry.lastModified == file->lastModified;
+	});
+}
+
+bool CppParseCache::tryRestoreFileByContentHash(CppParsedFile *parsedFile) {
+	CppFile *file = parsedFile->file.get();
+	return tryRestore(parsedFile, [&](Entry &entry) {
+		if (entry.fileSize != file->fileSize || entry.contentHash != parsedFile->contentHash) return false;
+		// Only the modification time has changed (e.g. the file was touched or checked out again) => update the time in the cache.
+		entry.lastModified = file->lastModified;
+		modified = true;
+		return true;
+	});
+}
+
+void CppParseCache::storeParseResult(CppParsedFile *parsedFile) {
+	ByteBuffer b;
+	writeParsedFile(&b, parsedFile);
+
+	Entry entry;
+	entry.fileSize = parsedFile->file->fileSize;
+	entry.lastModified = parsedFile->file->lastModified;
+	entry.contentHash = parsedFile->contentHash;
+	entry.data = make_shared<string>((const char *)b.getBuffer(), b.getPosition());
+	entry.usedInCurrentRound = true;
+
+	lock_guard<mutex> lockGuard(lock);
+	entriesByPath[parsedFile->file->getPath()] = entry;
+	modified = true;
+}
+
+void CppParseCache::removeEntriesNotUsedInCurrentRound() {
+	lock_guard<mutex> lockGuard(lock);
+	for (auto iter = entriesByPath.begin(); iter != entriesByPath.end();) {
+		if (iter->second.usedInCurrentRound) {
+			iter->second.usedInCurrentRound = false;
+			++iter;
+		}
+		else {
+			iter = entriesByPath.erase(iter);
+			modified = true;
+		}
+	}
+}
+
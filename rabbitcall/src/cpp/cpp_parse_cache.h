@@ -0,0 +1,53 @@
+#pragma once
+
+// Stores the parse results of source files on disk so that unchanged files don't need to be parsed again on the next run.
+// A file is considered unchanged if its size and last-modified time are the same as when it was parsed, or if only the time
+// has changed but the content hash is the same. Parse results of different files may be restored/stored concurrently.
+class CppParseCache {
+
+	struct Entry {
+		int64_t fileSize = 0;
+		int64_t lastModified = 0;
+		Hash128 contentHash;
+		shared_ptr<string> data; // Serialized CppParsedFile.
+		bool usedInCurrentRound = false;
+	};
+
+	Path path;
+	string parserSettings;
+	mutex lock;
+	unordered_map<string, Entry> entriesByPath;
+	bool modified = false;
+
+	static void writeComment(ByteBuffer *b, CppComment *comment);
+	static CppComment * readComment(ByteBuffer *b, Arena *arena);
+	static void writeSourceLocation(ByteBuffer *b, const SourceLocation &location);
+	static SourceLocation readSourceLocation(ByteBuffer *b, CppFile *file);
+	static void writeSourceCode(ByteBuffer *b, const CppSourceCodeView &sourceCode);
+	static CppSourceCodeView readSourceCode(ByteBuffer *b, CppFile *file); // Points to the buffer.
+	static void writeClass(ByteBuffer *b, CppClass *clazz);
+	static CppClass * readClass(ByteBuffer *b, CppFile *file, Arena *arena);
+	static void writeParsedFile(ByteBuffer *b, CppParsedFile *parsedFile);
+	static void readParsedFile(ByteBuffer *b, CppParsedFile *parsedFile);
+
+	bool tryRestore(CppParsedFile *parsedFile, const function<bool(Entry &)> &isEntryValid);
+
+public:
+	// If the path is empty, the cache is kept only in memory (e.g. between rounds in watch mode).
+	// The parser settings string should contain all configuration parameters that affect parse results so that the cache is discarded if they change.
+	CppParseCache(const Path &path, const string &parserSettings);
+	DISABLE_COPY_AND_MOVE(CppParseCache);
+
+	void load();
+	void saveIfModified();
+
+	// Restores the parse result if the file size and last-modified time are unchanged.
+	bool tryRestoreUnmodifiedFile(CppParsedFile *parsedFile);
+	// Restores the parse result if the content hash (already calculated in the parsed file) is unchanged.
+	bool tryRestoreFileByContentHash(CppParsedFile *parsedFile);
+	void storeParseResult(CppParsedFile *parsedFile);
+
+	// Removes entries for files that were not parsed in the current round (e.g. deleted files).
+	void removeEntriesNotUsedInCurrentRound();
+};
+
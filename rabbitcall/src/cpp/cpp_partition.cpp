@@ -11,8 +11,6 @@ CppPartition::CppPartition(const Config::Partition &partitionConfig, CppProject
 	errorList = cppProject->getErrorList();
 	typeMap = cppProject->getTypeMap();
 	
-	funcVarParser = make_shared<CppFuncVarParser>(config, typeMap);
-
 	for (const auto &entry : config->outputDirsByType) {
 		string fileType = entry.first;
 		const Config::OutputDir &outputDir = entry.second;
@@ -23,6 +21,14 @@ CppPartition::CppPartition(const Config::Partition &partitionConfig, CppProject
 		file->file = outputDir.path.path() / filename;
 		file->shouldWriteByteOrderMark = outputDir.shouldWriteByteOrderMark;
 		outputFilesByType[fileType] = file;
+
+		string dirName = sb() << "rabbitcall_generated_" << partitionName;
+		if (fileType == "cpp" && outputDir.isValid()) {
+			sourceHeaderCppOutputDir = outputDir.path.path() / dirName;
+		}
+		else if (fileType == "cs" && outputDir.isValid()) {
+			csPartOutputDir = outputDir.path.path() / dirName;
+		}
 	}
 }
 
@@ -35,7 +41,176 @@ shared_ptr<CppOutputFile> CppPartition::getOutputFileByTypeIfExists(const string
 	return iter->second;
 }
 
-void CppPartition::addClass(shared_ptr<CppClass> clazz) {
+vector<Path> CppPartition::getOutputFilePaths() {
+	vector<Path> result;
+	for (auto &entry : outputFilesByType) {
+		if (!entry.second->file.empty()) {
+			result.push_back(entry.second->file);
+		}
+	}
+	for (auto &file : sourceHeaderCppOutputFiles) {
+		result.push_back(file->file);
+	}
+	for (auto &file : csPartOutputFiles) {
+		result.push_back(file->file);
+	}
+	return result;
+}
+
+void CppPartition::initSourceHeaderCppOutputFiles() {
+	if (!config->generateCppFilePerSourceHeader || sourceHeaderCppOutputDir.empty() || cppSourceDirIfExists.empty()) return;
+
+	shared_ptr<CppOutputFile> cppOutputFile = getOutputFileByTypeIfExists("cpp");
+	for (const string &header : headerFilesUsed) {
+		// Mirror the source directory structure so that the names of the generated files don't depend on the other headers.
+		string relativePath = getRelativePathBetweenAbsolutePaths(header, cppSourceDirIfExists.toString());
+		boost::replace_all(relativePath, "\\", "/");
+		if (boost::starts_with(relativePath, "../")) EXC(sb() << "Source header is not inside the partition source directory: " << header);
+
+		shared_ptr<CppOutputFile> file = make_shared<CppOutputFile>();
+		file->file = sourceHeaderCppOutputDir.path() / (relativePath + ".cpp");
+		file->sourceHeaderFile = header;
+		file->shouldWriteByteOrderMark = cppOutputFile->shouldWriteByteOrderMark;
+		sourceHeaderCppOutputFiles.push_back(file);
+
+		string hash = calculateHash128(relativePath.data(), relativePath.size()).toHexString();
+		elementsBySourceHeader[header].initFunctionName = sb() << "initSourceHeader_" << partitionName << "_" << hash.substr(hash.size() - 8);
+	}
+}
+
+void CppPartition::collectSourceHeaderElements() {
+	if (elementsBySourceHeader.empty()) return;
+
+	for (CppClass *clazz : classes) {
+		auto iter = elementsBySourceHeader.find(clazz->sourceLocation.getFilename());
+		if (iter != elementsBySourceHeader.end()) iter->second.classes.push_back(clazz);
+	}
+	for (CppFuncVar *func : globalFunctions) {
+		auto iter = elementsBySourceHeader.find(func->sourceLocation.getFilename());
+		if (iter != elementsBySourceHeader.end()) iter->second.globalFunctions.push_back(func);
+	}
+}
+
+bool CppPartition::isInSourceHeaderCppOutputFile(const string &file) {
+	return !elementsBySourceHeader.empty() && contains(elementsBySourceHeader, file);
+}
+
+CppPartition::SourceHeaderElements * CppPartition::getSourceHeaderElements(const string &sourceHeaderFile) {
+	auto iter = elementsBySourceHeader.find(sourceHeaderFile);
+	if (iter == elementsBySourceHeader.end()) EXC(sb() << "Source header does not have a generated .cpp file: " << sourceHeaderFile);
+	return &iter->second;
+}
+
+string CppPartition::getCsOutputPartNameForClass(CppClass *clazz) {
+	if (config->csOutputSplitMode == CsOutputSplitMode::CLASS) {
+		return boost::replace_all_copy(clazz->typeNames.cppType, "::", ".");
+	}
+	return getCsOutputPartNameForGlobalFunctions(cppParseUtil->cppNamespaceParser.getNamespaceNameFromQualifiedName(clazz->typeNames.cppType));
+}
+
+string CppPartition::getCsOutputPartNameForGlobalFunctions(const string &namespaceName) {
+	string name = boost::replace_all_copy(namespaceName, "::", ".");
+	if (config->csOutputSplitMode == CsOutputSplitMode::CLASS) {
+		return name.empty() ? config->csGlobalFunctionContainerClass : name + "." + config->csGlobalFunctionContainerClass;
+	}
+	return name.empty() ? "_global" : name;
+}
+
+void CppPartition::initCsPartOutputFiles() {
+	if (config->csOutputSplitMode == CsOutputSplitMode::NONE || csPartOutputDir.empty()) return;
+
+	// The global functions are not resolved until linking, but the namespaces are already known, so the set of files can be determined
+	// before linking (e.g. for checking whether the files are up-to-date).
+	for (CppClass *clazz : classes) {
+		csOutputPartsByName[getCsOutputPartNameForClass(clazz)];
+	}
+	for (const auto &parsedFile : parsedFiles) {
+		for (CppUnresolvedFunction *func : parsedFile->unresolvedFunctions) {
+			if (func->enclosingClassIfExists) continue;
+			string ns = boost::ends_with(func->namespacePrefix, "::") ? func->namespacePrefix.substr(0, func->namespacePrefix.size() - 2) : func->namespacePrefix;
+			csOutputPartsByName[getCsOutputPartNameForGlobalFunctions(ns)].globalFunctionNamespace = ns;
+		}
+	}
+
+	shared_ptr<CppOutputFile> csOutputFile = getOutputFileByTypeIfExists("cs");
+	map<string, string> partNamesByLowerCaseName;
+	for (const auto &entry : csOutputPartsByName) {
+		// The files would overwrite each other on case-insensitive file systems.
+		string lowerCaseName = boost::to_lower_copy(entry.first);
+		auto iter = partNamesByLowerCaseName.find(lowerCaseName);
+		if (iter != partNamesByLowerCaseName.end()) EXC(sb() << "Generated C# files would have names differing only by case: " << iter->second << ", " << entry.first);
+		partNamesByLowerCaseName[lowerCaseName] = entry.first;
+
+		shared_ptr<CppOutputFile> file = make_shared<CppOutputFile>();
+		file->file = csPartOutputDir.path() / (entry.first + ".cs");
+		file->csOutputPart = entry.first;
+		file->shouldWriteByteOrderMark = csOutputFile->shouldWriteByteOrderMark;
+		csPartOutputFiles.push_back(file);
+	}
+}
+
+void CppPartition::collectCsOutputPartElements() {
+	if (csOutputPartsByName.empty()) return;
+
+	for (CppClass *clazz : classes) {
+		getCsOutputPart(getCsOutputPartNameForClass(clazz))->classes.push_back(clazz);
+	}
+	for (CppFuncVar *func : globalFunctions) {
+		getCsOutputPart(getCsOutputPartNameForGlobalFunctions(func->getNamespaceName()))->globalFunctions.push_back(func);
+	}
+}
+
+CppPartition::CsOutputPart * CppPartition::getCsOutputPart(const string &name) {
+	auto iter = csOutputPartsByName.find(name);
+	if (iter == csOutputPartsByName.end()) EXC(sb() << "C# output part does not exist: " << name);
+	return &iter->second;
+}
+
+Hash128 CppPartition::calculateSourceFileHash(bool onlyFilesWithExportedElements) {
+	StringBuilder b;
+	for (const auto &parsedFile : parsedFiles) {
+		if (onlyFilesWithExportedElements && !parsedFile->hasExportedElements()) continue;
+		CppFile *file = parsedFile->file.get();
+		b << file->getPath() << "\n" << file->fileSize << "\n" << file->lastModified << "\n";
+	}
+	return calculateHash128(b.buffer.data(), b.buffer.size());
+}
+
+void CppPartition::addSourceHeaderDependencies(const CppFuncVar *declaration, set<string> *headers) {
+	// Only the types of exported classes are declared in source headers, the others are defined in the configuration.
+	TypeMapping *typeMapping = declaration->type;
+	if (typeMapping && !typeMapping->partitionName.empty()) {
+		string file = typeMapping->sourceLocation.getFilename();
+		if (cppProject->isSourceHeaderFileUsed(file)) headers->insert(file);
+	}
+	for (const CppFuncVar *param : declaration->functionParameters) {
+		addSourceHeaderDependencies(param, headers);
+	}
+}
+
+void CppPartition::addSourceHeaderDependenciesOfGlobalFunction(CppFuncVar *func, set<string> *headers) {
+	string file = func->sourceLocation.getFilename();
+	if (isSourceHeaderFileUsed(file)) headers->insert(file);
+	addSourceHeaderDependencies(func, headers);
+}
+
+void CppPartition::addSourceHeaderDependenciesOfClass(CppClass *clazz, set<string> *headers) {
+	string file = clazz->sourceLocation.getFilename();
+	if (!isSourceHeaderFileUsed(file)) return;
+
+	// Enums are needed for the name mappings, and the other types for the size registration and the member function wrappers.
+	if (clazz->classType == CppClassDeclarationType::ENUM || clazz->typeMapping->hasDefinedSize()) {
+		headers->insert(file);
+	}
+	if (clazz->classType != CppClassDeclarationType::ENUM) {
+		for (CppFuncVar *func : getAccessibleMemberFunctions(clazz)) {
+			headers->insert(file);
+			addSourceHeaderDependencies(func, headers);
+		}
+	}
+}
+
+void CppPartition::addClass(CppClass *clazz) {
 	classes.push_back(clazz);
 }
 
@@ -58,22 +233,33 @@ void CppPartition::applyFileParseResult(shared_ptr<CppParsedFile> parsedFile) {
 	statistics.numSourceFiles++;
 }
 
-void CppPartition::startFindSourceFiles(ThreadPool::TaskSet *tasks) {
+void CppPartition::startFindSourceFiles(ThreadPool::TaskSet *tasks, const function<void(const shared_ptr<CppParsedFile> &)> &fileFoundCallback) {
 	if (!cppSourceDirIfExists.empty()) {
-		rootDir.initByScanningDirectoryForSourceFilesRecursivelyAndConcurrently(cppSourceDirIfExists, Path(), &cppSourceFileSet, tasks, errorList);
+		rootDir.initByScanningDirectoryForSourceFilesRecursivelyAndConcurrently(cppSourceDirIfExists, Path(), &cppSourceFileSet, tasks, errorList, [this, fileFoundCallback](const shared_ptr<CppFile> &sourceFile) {
+			if (cppProject->isFileInsideAnyOutputDir(sourceFile->getPath())) return; // Don't process generated files as source files.
+
+			// Checked before the file is queued for parsing so that a misconfigured project is not parsed in vain.
+			if (!errorList->runWithExceptionCheck([&] { cppProject->checkFileNotInsideAnotherPartition(Path(sourceFile->getPath()), this); })) return;
+
+			shared_ptr<CppParsedFile> parsedFile = make_shared<CppParsedFile>(sourceFile);
+			{
+				lock_guard<mutex> _(parsedFilesBeingFoundLock);
+				parsedFilesBeingFound[sourceFile.get()] = parsedFile;
+			}
+			fileFoundCallback(parsedFile);
+		});
 	}
 }
 
 void CppPartition::finishFindSourceFiles() {
+	// The files were found and parsed in a non-deterministic order => put them in the order of the (sorted) directory tree.
 	rootDir.forEachFileRecursively([&](const shared_ptr<CppFile> &sourceFile) {
-		Path path = Path(sourceFile->getPath());
-
-		cppProject->checkFileNotInsideAnotherPartition(path, this);
-
-		if (!cppProject->isFileInsideAnyOutputDir(path.toString())) { // Don't process generated files as source files.
-			parsedFiles.push_back(make_shared<CppParsedFile>(sourceFile));
+		auto iter = parsedFilesBeingFound.find(sourceFile.get());
+		if (iter != parsedFilesBeingFound.end()) {
+			parsedFiles.push_back(iter->second);
 		}
 	});
+	parsedFilesBeingFound.clear();
 }
 
 bool CppPartition::containsPath(const Path &path) {
@@ -81,23 +267,54 @@ bool CppPartition::containsPath(const Path &path) {
 	return cppSourceFileSet.isPathInSet(getRelativePathBetweenAbsolutePaths(path.toString(), cppSourceDirIfExists.toString()));
 }
 
-void CppPartition::resolveClassMembers() {
-	LOG_DETAIL("Resolving class members");
-	forEachClass([&](CppClass *clazz) {
+void CppPartition::runLinkTasksForParsedFiles(const function<void(LinkTask *)> &c) {
+	// The type map is read-only after all types have been identified, and each parsed file has its own classes, functions and line number map,
+	// so the files can be processed concurrently.
+	vector<unique_ptr<LinkTask>> linkTasks;
+	for (const auto &parsedFile : parsedFiles) {
+		if (parsedFile->hasExportedElements()) {
+			linkTasks.push_back(make_unique<LinkTask>(parsedFile.get(), config, typeMap));
+		}
+	}
+
+	ThreadPool::TaskSet tasks(app->threadPool.get());
+	for (const auto &linkTask : linkTasks) {
+		LinkTask *task = linkTask.get();
+		tasks.addTask([task, &c]() {
+			task->errorList.runWithExceptionCheck([&] {
+				c(task);
+			});
+		});
+	}
+	tasks.waitUntilEmpty();
+
+	for (const auto &task : linkTasks) {
+		errorList->addAll(&task->errorList);
+		cppProject->getArena()->merge(&task->arena);
+		for (const auto &dependency : task->classDependencies) {
+			cppProject->addClassDependency(dependency.first, dependency.second);
+		}
+		globalFunctions.insert(globalFunctions.end(), task->globalFunctions.begin(), task->globalFunctions.end());
+		statistics.numFunctions += task->numFunctions;
+	}
+}
+
+void CppPartition::resolveClassMembers(LinkTask *task) {
+	for (CppClass *clazz : task->parsedFile->classes) {
 		if (clazz->classType == CppClassDeclarationType::STRUCT) {
 			for (CppUnresolvedMember &member : clazz->unresolvedMembers) {
-				errorList->runWithExceptionCheck([&] {
-					CppSourceCodeView elements = member.sourceCode->getSourceCode();
+				task->errorList.runWithExceptionCheck([&] {
+					CppSourceCodeView elements = member.sourceCode;
 
-					if (!funcVarParser->tryIdentifyFunction(elements).isFunction) {
+					if (!task->funcVarParser.tryIdentifyFunction(elements).isFunction) {
 						// The declaration is not a function => parse it as a variable or a list of variables.
-						shared_ptr<CppFuncVar> baseType; // Holds the variable type from the first variable in the list so that it can be used for subsequent variables.
+						CppFuncVar *baseType = nullptr; // Holds the variable type from the first variable in the list so that it can be used for subsequent variables.
 						CppElementIterator variableIter(elements, nullptr);
 						bool firstVariable = true;
 						while (variableIter.isValid()) {
 							CppElementIterator::InfiniteLoopGuard variableLoopGuard(&variableIter);
 
-							CppFuncVarParser::ParseVariableResult variableResult = funcVarParser->parseVariableDeclaration(variableIter, true, &baseType);
+							CppFuncVarParser::ParseVariableResult variableResult = task->funcVarParser.parseVariableDeclaration(variableIter, true, &baseType);
 
 							if (firstVariable) {
 								// If multiple variables are declared on the same line in C++, output the comment to the first variable only.
@@ -107,9 +324,9 @@ void CppPartition::resolveClassMembers() {
 							clazz->fields.push_back(variableResult.decl);
 							LOG_DEBUG(sb() << "Parsing field: " << variableResult.decl->declarationName);
 
-							CppClass *dependeeClass = cppProject->getClassByCppNameIfExists(variableResult.decl->type->typeNames.cppType).get();
+							CppClass *dependeeClass = cppProject->getClassByCppNameIfExists(variableResult.decl->type->typeNames.cppType);
 							if (dependeeClass) {
-								cppProject->addClassDependency(clazz, dependeeClass);
+								task->classDependencies.emplace_back(clazz, dependeeClass);
 							}
 
 							if (!variableResult.doesListContinue) {
@@ -123,6 +340,13 @@ void CppPartition::resolveClassMembers() {
 				});
 			}
 		}
+	}
+}
+
+void CppPartition::resolveClassMembers() {
+	LOG_DETAIL("Resolving class members");
+	runLinkTasksForParsedFiles([&](LinkTask *task) {
+		resolveClassMembers(task);
 	});
 }
 
@@ -131,32 +355,32 @@ void CppPartition::resolveSuperclasses() {
 	forEachClass([&](CppClass *clazz) {
 		for (CppSuperclassRef &superclassRef : clazz->superclasses) {
 			TypeMapping *typeMapping = typeMap->getTypeMappingByPossiblyPartiallyQualifiedCppTypeOrThrow(superclassRef.partialName, superclassRef.sourceLocation);
-			shared_ptr<CppClass> superclass = cppProject->getClassByCppNameIfExists(typeMapping->typeNames.cppType);
+			CppClass *superclass = cppProject->getClassByCppNameIfExists(typeMapping->typeNames.cppType);
 			if (!superclass) throw ParseException(superclassRef.sourceLocation, sb() << "Base class must be a custom class: " << typeMapping->typeNames.cppType);
 			superclassRef.fullyQualifiedName = typeMapping->typeNames.cppType;
 
-			cppProject->addClassDependency(clazz, superclass.get());
+			cppProject->addClassDependency(clazz, superclass);
 		}
 	});
 }
 
-void CppPartition::buildStructLayout(CppClass *c) {
+void CppPartition::buildStructLayout(CppClass *c, CppStructLayout *layout) {
 	CHECK_NOT_NULL(c);
 
 	if (c->classType != CppClassDeclarationType::STRUCT) {
 		return;
 	}
+	CHECK_NOT_NULL(layout);
 
 	if (c->layout) EXC(sb() << "Attempted to create layout for same class twice: " << c->typeNames.cppType);
 	if (!c->superclasses.empty()) EXC(sb() << "Supertypes for a pass-by-value type are not supported: " << c->typeNames.cppType); // The layout is not defined in C++ standard and may depend on compiler.
 
 	LOG_DEBUG(sb() << "Building class layout: " << c->typeNames.cppType);
 
-	shared_ptr<CppStructLayout> layout = make_shared<CppStructLayout>();
 	int64_t maxAlignment = max((size_t)1, c->typeMapping->alignment);
 	int64_t nextOffset = 0;
 
-	for (const shared_ptr<CppFuncVar> &sourceField : c->fields) {
+	for (CppFuncVar *sourceField : c->fields) {
 		if (!sourceField->isStatic) {
 			TypeMapping *typeMapping = sourceField->type;
 
@@ -167,7 +391,7 @@ void CppPartition::buildStructLayout(CppClass *c) {
 			f.sourceLocation = sourceField->sourceLocation;
 			f.comment = sourceField->comment;
 
-			f.typeNames = typeMapping->typeNames;
+			f.type = typeMapping;
 			f.elementSize = typeMapping->size;
 			f.alignment = max((int64_t)typeMapping->alignment, (int64_t)sourceField->explicitAlignment);
 
@@ -177,8 +401,8 @@ void CppPartition::buildStructLayout(CppClass *c) {
 			}
 
 			if (f.elementSize == 0) {
-				errorList->addError(sourceField->sourceLocation, sb() << "Type size unknown: " << typeMapping->typeNames.cppType);
-				return;
+				// Thrown instead of added to the partition's error list, because this runs in a task with an error list of its own.
+				throw ParseException(sourceField->sourceLocation, sb() << "Type size unknown: " << typeMapping->typeNames.cppType);
 			}
 
 			int64_t totalFieldSize = f.elementSize;
@@ -212,27 +436,49 @@ void CppPartition::buildStructLayout(CppClass *c) {
 void CppPartition::buildStructLayouts() {
 	LOG_DETAIL(sb() << "Building struct layouts");
 
-	list<CppClass *> buildQueue;
+	vector<CppClass *> currentLevel;
 	forEachClass([&](CppClass *c) {
-		// Add those classes to the build queue that don't have any dependencies.
+		// The first level contains those classes that don't have any dependencies.
 		c->unprocessedDependeeClasses.insert(c->dependeeClasses.begin(), c->dependeeClasses.end());
 		if (c->unprocessedDependeeClasses.empty()) {
-			buildQueue.push_back(c);
+			currentLevel.push_back(c);
 		}
 	});
 
-	while (!buildQueue.empty()) {
-		CppClass *c = buildQueue.front();
-		buildQueue.pop_front();
+	while (!currentLevel.empty()) {
+		// The classes on the same level don't depend on each other, so their layouts can be built concurrently. The layouts are allocated
+		// beforehand because the arena is not thread-safe.
+		vector<CppStructLayout *> layouts(currentLevel.size());
+		for (size_t i = 0; i < currentLevel.size(); i++) {
+			if (currentLevel[i]->classType == CppClassDeclarationType::STRUCT) {
+				layouts[i] = cppProject->getArena()->create<CppStructLayout>();
+			}
+		}
+
+		vector<ErrorList> levelErrorLists(currentLevel.size());
+		ThreadPool::TaskSet tasks(app->threadPool.get());
+		for (size_t i = 0; i < currentLevel.size(); i++) {
+			tasks.addTask([&, i]() {
+				levelErrorLists[i].runWithExceptionCheck([&] {
+					buildStructLayout(currentLevel[i], layouts[i]);
+				});
+			});
+		}
+		tasks.waitUntilEmpty();
 
-		buildStructLayout(c);
+		vector<CppClass *> nextLevel;
+		for (size_t i = 0; i < currentLevel.size(); i++) {
+			errorList->addAll(&levelErrorLists[i]);
 
-		for (auto &dependent : c->dependentClasses) {
-			dependent->unprocessedDependeeClasses.erase(c);
-			if (dependent->unprocessedDependeeClasses.empty()) {
-				buildQueue.push_back(dependent);
+			CppClass *c = currentLevel[i];
+			for (auto &dependent : c->dependentClasses) {
+				dependent->unprocessedDependeeClasses.erase(c);
+				if (dependent->unprocessedDependeeClasses.empty()) {
+					nextLevel.push_back(dependent);
+				}
 			}
 		}
+		currentLevel.swap(nextLevel);
 	}
 
 	vector<string> unprocessedClasses;
@@ -246,26 +492,30 @@ void CppPartition::buildStructLayouts() {
 	}
 }
 
-void CppPartition::resolveFunctions() {
-	LOG_DETAIL("Resolving functions");
-	for (auto &parsedFile : parsedFiles) {
-		for (auto &func : parsedFile->unresolvedFunctions) {
-			shared_ptr<CppFuncVar> functionDecl = funcVarParser->tryParseFunctionDeclaration(func->sourceCode->getSourceCode(), func->namespacePrefix);
-			if (functionDecl) {
-				functionDecl->comment = func->comment;
-
-				if (func->enclosingClassIfExists) {
-					func->enclosingClassIfExists->functions.push_back(functionDecl);
-				}
-				else {
-					globalFunctions.push_back(functionDecl);
-				}
-				statistics.numFunctions++;
+void CppPartition::resolveFunctions(LinkTask *task) {
+	for (CppUnresolvedFunction *func : task->parsedFile->unresolvedFunctions) {
+		CppFuncVar *functionDecl = task->funcVarParser.tryParseFunctionDeclaration(func->sourceCode, func->namespacePrefix);
+		if (functionDecl) {
+			functionDecl->comment = func->comment;
+
+			if (func->enclosingClassIfExists) {
+				func->enclosingClassIfExists->functions.push_back(functionDecl);
+			}
+			else {
+				task->globalFunctions.push_back(functionDecl);
 			}
+			task->numFunctions++;
 		}
 	}
 }
 
+void CppPartition::resolveFunctions() {
+	LOG_DETAIL("Resolving functions");
+	runLinkTasksForParsedFiles([&](LinkTask *task) {
+		resolveFunctions(task);
+	});
+}
+
 void CppPartition::linkParsedFiles() {
 	if (errorList->hasErrors()) return;
 
@@ -303,20 +553,20 @@ void CppPartition::forEachParsedFile(const function<void(const shared_ptr<CppPar
 
 void CppPartition::forEachGlobalFunction(const function<void(CppFuncVar *declaration)> &c) {
 	for (auto &declaration : globalFunctions) {
-		c(declaration.get());
+		c(declaration);
 	}
 }
 
 void CppPartition::forEachClass(const function<void(CppClass *clazz)> &c) {
 	for (auto &entry : classes) {
-		c(entry.get());
+		c(entry);
 	}
 }
 
 void CppPartition::forEachEnum(const function<void(CppClass *clazz)> &c) {
 	for (auto &entry : classes) {
 		if (entry->classType == CppClassDeclarationType::ENUM) {
-			c(entry.get());
+			c(entry);
 		}
 	}
 }
@@ -327,7 +577,7 @@ void CppPartition::forEachSuperclassDepthFirst(CppClass *clazz, bool recursive,
 		CppAccessModifier accessModifier = getStrictenedAccessModifier(superclassRef.accessModifier, stricteningAccessModifier);
 
 		string superclassName = superclassRef.fullyQualifiedName;
-		CppClass *superclass = cppProject->getClassByCppNameIfExists(superclassRef.fullyQualifiedName).get();
+		CppClass *superclass = cppProject->getClassByCppNameIfExists(superclassRef.fullyQualifiedName);
 		if (!superclass) throw ParseException(clazz->sourceLocation, sb() << "Superclass not found: " << superclassName);
 
 		if (recursive) {
@@ -347,7 +597,7 @@ void CppPartition::forEachMemberFunction(CppClass *clazz, bool includeSuperclass
 	}
 
 	for (auto &func : clazz->functions) {
-		c(clazz, func.get(), getStrictenedAccessModifier(func->accessModifier, stricteningAccessModifier));
+		c(clazz, func, getStrictenedAccessModifier(func->accessModifier, stricteningAccessModifier));
 	}
 }
 
@@ -364,24 +614,63 @@ void CppPartition::forEachMemberVariable(CppClass *clazz, bool includeSuperclass
 	}
 }
 
-string CppPartition::getFunctionEntryPoint(CppFuncVar *func, CppClass *enclosingClassIfNotGlobal) {
-	string contextName; // Fully-qualified class name, namespace name (for global functions), or other unique context name.
-	if (enclosingClassIfNotGlobal) {
-		contextName = enclosingClassIfNotGlobal->typeNames.cppType;
+static string getFunctionContextName(CppFuncVar *func, CppClass *enclosingClassIfNotGlobal) {
+	// Fully-qualified class name, namespace name (for global functions), or other unique context name.
+	if (enclosingClassIfNotGlobal) return enclosingClassIfNotGlobal->typeNames.cppType;
+	return func->namespacePrefixIfGlobal + "global";
+}
+
+string CppPartition::getStableIdentifierSuffix(const string &signature) {
+	if (!config->stableEntryPointNames) return "";
+	// Use the lowest 32 bits of the hash, which is enough to make collisions rare (they still get a number suffix).
+	string hash = calculateHash128(signature.data(), signature.size()).toHexString();
+	return "_" + hash.substr(hash.size() - 8);
+}
+
+void CppPartition::reserveGeneratedIdentifiers(CppFuncVar *func, CppClass *enclosingClassIfNotGlobal) {
+	string contextName = getFunctionContextName(func, enclosingClassIfNotGlobal);
+	// The fully-qualified signature identifies the function independently of the other functions (unless there are duplicate declarations),
+	// so the stable names don't change when functions are added or removed elsewhere.
+	string functionSignature = config->stableEntryPointNames ? (string)(sb() << contextName << "::" << func->declarationName << CppItemParseUtil::getTypeSignature(func, true)) : "";
+
+	for (CppFuncVar *param : func->functionParameters) {
+		if (param->isLambdaFunction && param->callbackWrapperClassNameByContext.find(contextName) == param->callbackWrapperClassNameByContext.end()) {
+			string suffix = getStableIdentifierSuffix(sb() << functionSignature << "/" << param->declarationName);
+			param->callbackWrapperClassNameByContext[contextName] = cppProject->reserveCppGlobalIdentifier(sb() << OUTPUT_CALLBACK "_" << (enclosingClassIfNotGlobal ? enclosingClassIfNotGlobal->typeNames.cppType : "global") << "_" << func->declarationName << "_" << param->declarationName << suffix);
+		}
 	}
-	else {
-		contextName = func->namespacePrefixIfGlobal + "global";
+
+	if (func->functionEntryPointNameByContext.find(contextName) == func->functionEntryPointNameByContext.end()) {
+		string transformedContextName = contextName;
+		boost::replace_all(transformedContextName, "::", "_");
+		func->functionEntryPointNameByContext[contextName] = cppProject->reserveCppGlobalIdentifier(sb() << "rabbitcall_" << transformedContextName << "_" << func->declarationName << getStableIdentifierSuffix(functionSignature));
 	}
+}
 
-	auto iter = func->functionEntryPointNameByContext.find(contextName);
-	if (iter != func->functionEntryPointNameByContext.end()) return iter->second;
+void CppPartition::reserveGeneratedIdentifiers() {
+	// Use the same order as in the generated C++ file.
+	forEachGlobalFunction([&](CppFuncVar *func) {
+		reserveGeneratedIdentifiers(func, nullptr);
+	});
+	forEachClass([&](CppClass *clazz) {
+		if (clazz->classType != CppClassDeclarationType::ENUM) {
+			for (CppFuncVar *func : getAccessibleMemberFunctions(clazz)) {
+				reserveGeneratedIdentifiers(func, clazz);
+			}
+		}
+	});
+}
 
-	string transformedContextName = contextName;
-	boost::replace_all(transformedContextName, "::", "_");
+string CppPartition::getFunctionEntryPoint(CppFuncVar *func, CppClass *enclosingClassIfNotGlobal) {
+	auto iter = func->functionEntryPointNameByContext.find(getFunctionContextName(func, enclosingClassIfNotGlobal));
+	if (iter == func->functionEntryPointNameByContext.end()) EXC(sb() << "Entry point name not reserved for function: " << func->declarationName);
+	return iter->second;
+}
 
-	string entryPoint = cppProject->reserveCppGlobalIdentifier(sb() << "rabbitcall_" << transformedContextName << "_" << func->declarationName);
-	func->functionEntryPointNameByContext[contextName] = entryPoint;
-	return entryPoint;
+string CppPartition::getCallbackWrapperClassName(CppFuncVar *callbackParam, CppFuncVar *enclosingFunction, CppClass *enclosingClassIfNotGlobal) {
+	auto iter = callbackParam->callbackWrapperClassNameByContext.find(getFunctionContextName(enclosingFunction, enclosingClassIfNotGlobal));
+	if (iter == callbackParam->callbackWrapperClassNameByContext.end()) EXC(sb() << "Callback wrapper name not reserved for parameter: " << enclosingFunction->declarationName << "/" << callbackParam->declarationName);
+	return iter->second;
 }
 
 vector<CppFuncVar *> CppPartition::getAccessibleMemberFunctions(CppClass *clazz) {
@@ -4,11 +4,49 @@ class CppProject;
 
 struct CppOutputFile {
 	Path file;
+	string sourceHeaderFile; // Set if this is a .cpp file generated for a single source header.
+	string csOutputPart; // Set if this is a .cs file generated for a part of the partition (see Config::csOutputSplitMode).
 	bool shouldWriteByteOrderMark = false;
+
+	bool isInGeneratedSubdirectory() const { return !sourceHeaderFile.empty() || !csOutputPart.empty(); }
 };
 
 // The source files may be split to multiple partitions if the source code size is large.
 class CppPartition {
+
+	// The results of linking one parsed file in a background task. The results that modify shared state are applied on the main thread
+	// in file order after all tasks have completed so that the outcome does not depend on the order in which the tasks were run.
+	struct LinkTask {
+		CppParsedFile *parsedFile = nullptr;
+		Arena arena;
+		ErrorList errorList;
+		CppFuncVarParser funcVarParser;
+		vector<pair<CppClass *, CppClass *>> classDependencies; // Dependent, dependee.
+		vector<CppFuncVar *> globalFunctions;
+		int64_t numFunctions = 0;
+
+		LinkTask(CppParsedFile *parsedFile, Config *config, TypeMap *typeMap)
+			: parsedFile(parsedFile), funcVarParser(config, typeMap, &arena) {
+		}
+	};
+
+public:
+	// The exported elements of a source header whose glue code is generated to a separate .cpp file.
+	struct SourceHeaderElements {
+		string initFunctionName;
+		vector<CppClass *> classes;
+		vector<CppFuncVar *> globalFunctions;
+	};
+
+	// The classes and global functions that are generated to a separate .cs file.
+	struct CsOutputPart {
+		string globalFunctionNamespace;
+		vector<CppFuncVar *> globalFunctions; // All from the same namespace.
+		vector<CppClass *> classes;
+	};
+
+private:
+
 	string partitionName;
 	Config *config = nullptr;
 	ErrorList *errorList = nullptr;
@@ -16,15 +54,27 @@ class CppPartition {
 	TypeMap *typeMap = nullptr;
 	Path cppSourceDirIfExists;
 	FileSet cppSourceFileSet;
-	shared_ptr<CppFuncVarParser> funcVarParser;
 
 	CppSourceDirectory rootDir;
 	vector<shared_ptr<CppParsedFile>> parsedFiles;
-	vector<shared_ptr<CppFuncVar>> globalFunctions;
-	vector<shared_ptr<CppClass>> classes;
+	mutex parsedFilesBeingFoundLock;
+	unordered_map<CppFile *, shared_ptr<CppParsedFile>> parsedFilesBeingFound; // Files that have been found, but are not yet in the sorted list.
+	vector<CppFuncVar *> globalFunctions;
+	vector<CppClass *> classes;
 	set<string> headerFilesUsed;
 	map<string, shared_ptr<CppOutputFile>> outputFilesByType;
+	Path sourceHeaderCppOutputDir; // Empty if there is no .cpp output.
+	vector<shared_ptr<CppOutputFile>> sourceHeaderCppOutputFiles;
+	unordered_map<string, SourceHeaderElements> elementsBySourceHeader;
+	Path csPartOutputDir; // Empty if there is no .cs output.
+	vector<shared_ptr<CppOutputFile>> csPartOutputFiles;
+	map<string, CsOutputPart> csOutputPartsByName;
+
+	string getCsOutputPartNameForClass(CppClass *clazz);
+	string getCsOutputPartNameForGlobalFunctions(const string &namespaceName);
 	CppStatistics statistics;
+	Hash128 fingerprint; // Calculated only if the output manifest is used.
+	bool outputUpToDate = false; // True if the fingerprint matches the previous run, so the output files don't need to be generated.
 
 public:
 	explicit CppPartition(const Config::Partition &partitionConfig, CppProject *cppProject);
@@ -39,20 +89,56 @@ public:
 	Path getCppSourceDirIfExists() { return cppSourceDirIfExists; }
 	FileSet * getCppSourceFileSet() { return &cppSourceFileSet; }
 	shared_ptr<CppOutputFile> getOutputFileByTypeIfExists(const string &fileType);
+	vector<Path> getOutputFilePaths();
+
+	// The .cpp files generated per source header if enabled (see Config::generateCppFilePerSourceHeader).
+	Path getSourceHeaderCppOutputDir() { return sourceHeaderCppOutputDir; }
+	const vector<shared_ptr<CppOutputFile>> & getSourceHeaderCppOutputFiles() { return sourceHeaderCppOutputFiles; }
+	void initSourceHeaderCppOutputFiles();
+	void collectSourceHeaderElements(); // Must be called after linking.
+	bool isInSourceHeaderCppOutputFile(const string &file);
+	SourceHeaderElements * getSourceHeaderElements(const string &sourceHeaderFile);
 
-	void addClass(shared_ptr<CppClass> clazz);
+	// The .cs files generated for parts of the partition if enabled (see Config::csOutputSplitMode).
+	Path getCsPartOutputDir() { return csPartOutputDir; }
+	const vector<shared_ptr<CppOutputFile>> & getCsPartOutputFiles() { return csPartOutputFiles; }
+	bool hasCsOutputParts() { return !csOutputPartsByName.empty(); }
+	void initCsPartOutputFiles();
+	void collectCsOutputPartElements(); // Must be called after linking.
+	CsOutputPart * getCsOutputPart(const string &name);
+
+	// Hash of the paths, sizes and last-modified times of the source files (optionally only those with exported elements).
+	Hash128 calculateSourceFileHash(bool onlyFilesWithExportedElements);
+	const Hash128 & getFingerprint() { return fingerprint; }
+	void setFingerprint(const Hash128 &value) { fingerprint = value; }
+	bool isOutputUpToDate() { return outputUpToDate; }
+	void setOutputUpToDate(bool value) { outputUpToDate = value; }
+
+	void addClass(CppClass *clazz);
 	void applyFileParseResult(shared_ptr<CppParsedFile> parsedFile);
 	set<string> getSourceHeaderFilesUsed() { return headerFilesUsed; }
+	bool isSourceHeaderFileUsed(const string &path) { return contains(headerFilesUsed, path); }
+
+	// Adds the source headers that are needed for compiling the generated C++ glue code of a global function or a class: the headers that
+	// declare the function/class and the types in the function signatures (including callback parameters).
+	void addSourceHeaderDependencies(const CppFuncVar *declaration, set<string> *headers);
+	void addSourceHeaderDependenciesOfGlobalFunction(CppFuncVar *func, set<string> *headers);
+	void addSourceHeaderDependenciesOfClass(CppClass *clazz, set<string> *headers);
 	CppStatistics * getStatistics() { return &statistics; }
 
-	void startFindSourceFiles(ThreadPool::TaskSet *tasks);
+	// Finds the source files and passes each of them to the callback (possibly concurrently) as soon as it is found, e.g. to be parsed.
+	// After all the tasks have completed, finishFindSourceFiles() puts the parsed files in a deterministic order.
+	void startFindSourceFiles(ThreadPool::TaskSet *tasks, const function<void(const shared_ptr<CppParsedFile> &)> &fileFoundCallback);
 	void finishFindSourceFiles();
 	bool containsPath(const Path &path);
 	
+	void runLinkTasksForParsedFiles(const function<void(LinkTask *)> &c);
+	void resolveClassMembers(LinkTask *task);
 	void resolveClassMembers();
 	void resolveSuperclasses();
-	void buildStructLayout(CppClass *c);
+	void buildStructLayout(CppClass *c, CppStructLayout *layout);
 	void buildStructLayouts();
+	void resolveFunctions(LinkTask *task);
 	void resolveFunctions();
 	void linkParsedFiles();
 
@@ -65,6 +151,12 @@ public:
 	void forEachSuperclassDepthFirst(CppClass *clazz, bool recursive, CppAccessModifier stricteningAccessModifier, const function<void(CppClass *, CppAccessModifier)> &c);
 	void forEachMemberFunction(CppClass *clazz, bool includeSuperclasses, CppAccessModifier stricteningAccessModifier, const function<void(CppClass *, CppFuncVar *, CppAccessModifier)> &c);
 	void forEachMemberVariable(CppClass *clazz, bool includeSuperclasses, CppAccessModifier stricteningAccessModifier, const function<void(CppClass *, CppStructLayout::Field *, CppAccessModifier)> &c);
+	string getStableIdentifierSuffix(const string &signature); // Empty unless stable entry point names are enabled.
+	// Reserves the generated C++ entry point and callback wrapper names before the output files are generated concurrently, so that the names
+	// don't depend on the order in which the files are generated.
+	void reserveGeneratedIdentifiers(CppFuncVar *func, CppClass *enclosingClassIfNotGlobal);
+	void reserveGeneratedIdentifiers();
 	string getFunctionEntryPoint(CppFuncVar * func, CppClass *enclosingClassIfNotGlobal);
+	string getCallbackWrapperClassName(CppFuncVar *callbackParam, CppFuncVar *enclosingFunction, CppClass *enclosingClassIfNotGlobal);
 	vector<CppFuncVar *> getAccessibleMemberFunctions(CppClass *clazz);
 };
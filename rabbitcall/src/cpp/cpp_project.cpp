@@ -6,13 +6,13 @@ CppProject::CppProject(Config *config, ErrorList *errorList)
 
 	typeMap = make_shared<TypeMap>(config);
 
-	shared_ptr<TypeMapping> stdFunctionTypeMapping = make_shared<TypeMapping>();
+	TypeMapping *stdFunctionTypeMapping = arena.create<TypeMapping>();
 	stdFunctionTypeMapping->typeNames.cppType = "std::function";
 	typeMap->addTypeMapping(stdFunctionTypeMapping);
 
 	for (const Config::TypeMapping &m : config->typeMappings) {
 
-		shared_ptr<TypeMapping> typeMapping = make_shared<TypeMapping>();
+		TypeMapping *typeMapping = arena.create<TypeMapping>();
 		typeMapping->typeNames = m.typeNames;
 		typeMapping->marshal = m.marshal;
 		typeMapping->charType = m.charType;
@@ -35,6 +35,13 @@ bool CppProject::isFileInsideAnyOutputDir(const string &path) {
 	return false;
 }
 
+bool CppProject::isSourceHeaderFileUsed(const string &path) {
+	for (const auto &partition : partitions) {
+		if (partition->isSourceHeaderFileUsed(path)) return true;
+	}
+	return false;
+}
+
 void CppProject::checkFileNotInsideAnotherPartition(const Path &path, CppPartition *partition) {
 	for (const auto &otherPartition : partitions) {
 		if (otherPartition.get() != partition) {
@@ -63,7 +70,7 @@ shared_ptr<CppPartition> CppProject::createPartitionIfDoesNotExist(const Config:
 	return partition;
 }
 
-bool CppProject::addClassIfDoesNotExist(shared_ptr<CppClass> clazz, CppPartition *partition) {
+bool CppProject::addClassIfDoesNotExist(CppClass *clazz, CppPartition *partition) {
 	string name = clazz->typeNames.cppType;
 	auto iter = classesByName.find(name);
 	if (iter != classesByName.end()) return false;
@@ -72,7 +79,7 @@ bool CppProject::addClassIfDoesNotExist(shared_ptr<CppClass> clazz, CppPartition
 	return true;
 }
 
-shared_ptr<CppClass> CppProject::getClassByCppNameIfExists(const string &cppName) {
+CppClass * CppProject::getClassByCppNameIfExists(const string &cppName) {
 	const string &name = cppName;
 	auto iter = classesByName.find(name);
 	if (iter == classesByName.end()) return nullptr;
@@ -89,12 +96,13 @@ void CppProject::addClassDependency(CppClass *dependent, CppClass *dependee) {
 
 void CppProject::applyFileParseResult(shared_ptr<CppParsedFile> parsedFile, CppPartition *partition) {
 	errorList->addAll(&parsedFile->errorList);
+	arena.merge(&parsedFile->arena);
 
-	for (const shared_ptr<CppClass> &clazz : parsedFile->classes) {
+	for (CppClass *clazz : parsedFile->classes) {
 		if (!addClassIfDoesNotExist(clazz, partition)) throw ParseException(clazz->sourceLocation, sb() << "Multiple classes exported with the same name: " << clazz->typeNames.cppType);
 
 		// The "explicit alignment" here means the alignas() keyword and the alignment of the type mapping may be updated later when the layout is built.
-		shared_ptr<TypeMapping> typeMapping = make_shared<TypeMapping>();
+		TypeMapping *typeMapping = arena.create<TypeMapping>();
 		typeMapping->typeNames = clazz->typeNames;
 		typeMapping->alignment = clazz->explicitAlignment;
 		typeMapping->isPassByValue = clazz->isPassByValue;
@@ -115,41 +123,295 @@ void CppProject::linkParsedFiles() {
 	}
 }
 
-void CppProject::generateOutputFiles() {
+bool CppProject::shouldUseCrLfLineBreaks() {
 	// Check whether CRLF or LF line-breaks are more popular in the source code and use the same ones in generated code.
-	bool shouldUseCrLfLineBreaks = lineBreakCountsInSource.crLfCount > lineBreakCountsInSource.lfCount;
+	return lineBreakCountsInSource.crLfCount > lineBreakCountsInSource.lfCount;
+}
+
+bool CppProject::checkWhichPartitionsAreUpToDate() {
+	if (!app->outputManifest) return false;
+	app->outputManifest->startRound();
+
+	// The output of a partition depends on its own source files and on the types exported from the other partitions
+	// (e.g. superclasses and type mappings), which can only change if a file with exported elements changes.
+	vector<Hash128> exportedFileHashes;
+	for (const auto &partition : partitions) {
+		exportedFileHashes.push_back(partition->calculateSourceFileHash(true));
+	}
+
+	bool allUpToDate = true;
+	for (size_t i = 0; i < partitions.size(); i++) {
+		const auto &partition = partitions.at(i);
+		Hash128 ownFileHash = partition->calculateSourceFileHash(false);
+
+		StringBuilder b;
+		b << config->outputSettingsHash.toHexString() << "\n" << shouldUseCrLfLineBreaks() << "\n";
+		b << partition->getName() << "\n" << ownFileHash.toHexString() << "\n";
+		for (size_t j = 0; j < partitions.size(); j++) {
+			b << partitions.at(j)->getName() << "\n";
+			if (j != i) b << exportedFileHashes.at(j).toHexString() << "\n";
+		}
+		partition->setFingerprint(calculateHash128(b.buffer.data(), b.buffer.size()));
+
+		bool upToDate = app->outputManifest->isPartitionUnchanged(partition->getName(), partition->getFingerprint(), partition->getOutputFilePaths());
+		partition->setOutputUpToDate(upToDate);
+		if (upToDate) {
+			LOG_DEBUG(sb() << "Partition is up-to-date according to output manifest: " << partition->getName());
+		}
+		else {
+			allUpToDate = false;
+		}
+	}
+	return allUpToDate;
+}
+
+void CppProject::generateOutputFiles() {
+	bool useCrLfLineBreaks = shouldUseCrLfLineBreaks();
 	LOG_DEBUG(sb() << "Total line breaks in source: CR-LF: " << lineBreakCountsInSource.crLfCount << ", LF: " << lineBreakCountsInSource.lfCount);
 
 	if (!partitions.empty()) {
 		// Consider the first partition the "main" partition whose generated files contain all the common definitions.
 		shared_ptr<CppPartition> mainPartition = partitions.at(0);
-		
+
+		for (const auto &partition : partitions) {
+			partition->reserveGeneratedIdentifiers();
+			partition->collectSourceHeaderElements();
+			partition->collectCsOutputPartElements();
+		}
+
+		// The C++ and C# generators are also used for the per-header .cpp files and the split .cs files.
+		function<unique_ptr<OutputFileGenerator>()> cppGeneratorFactory = [] { return make_unique<CppOutputGenerator>(); };
+		function<unique_ptr<OutputFileGenerator>()> csGeneratorFactory = [] { return make_unique<CsOutputGenerator>(); };
+		vector<function<unique_ptr<OutputFileGenerator>()>> generatorFactories = {
+			[] { return make_unique<HeaderOutputGenerator>(); },
+			cppGeneratorFactory,
+			csGeneratorFactory,
+			[] { return make_unique<HlslOutputGenerator>(); },
+			[] { return make_unique<GlslOutputGenerator>(); }
+		};
+
+		// Generate each file of each partition in its own task. The errors are collected per file and reported in the same order as if the files were generated one by one.
+		vector<unique_ptr<ErrorList>> fileErrorLists;
+		ThreadPool::TaskSet tasks(app->threadPool.get());
+		auto addGenerateTask = [&](CppPartition *partitionPtr, const function<unique_ptr<OutputFileGenerator>()> &generatorFactory, CppOutputFile *outputFileIfNotDefault) {
+			fileErrorLists.push_back(make_unique<ErrorList>());
+			ErrorList *fileErrorList = fileErrorLists.back().get();
+			tasks.addTask([=, &generatorFactory, &mainPartition]() {
+				fileErrorList->runWithExceptionCheck([&] {
+					unique_ptr<OutputFileGenerator> generator = generatorFactory();
+					generator->init(partitionPtr, mainPartition.get(), outputFileIfNotDefault);
+
+					CppOutputFile *outputFile = generator->getOutputFile();
+					if (outputFile && !outputFile->file.empty()) {
+						StopWatch fileStopWatch = app->createStopWatchForPerformanceMeasurement();
+						if (outputFile->isInGeneratedSubdirectory() && !config->dryRunMode) {
+							create_directories(outputFile->file.path().parent_path());
+						}
+						ChunkedOutput chunkedOutput(outputFile->shouldWriteByteOrderMark, useCrLfLineBreaks);
+						StringBuilder output;
+						output.chunkedOutput = &chunkedOutput;
+						generator->generateOutput(output);
+						output.flushToChunkedOutput();
+						fileStopWatch.mark("output / generate");
+						generator->updateGeneratedUtf8FileIfModified(outputFile->file, chunkedOutput, config->dryRunMode);
+						fileStopWatch.mark("output / update file");
+					}
+				});
+			});
+		};
+		for (const auto &partition : partitions) {
+			if (partition->isOutputUpToDate()) continue;
+			for (const auto &generatorFactory : generatorFactories) {
+				addGenerateTask(partition.get(), generatorFactory, nullptr);
+			}
+			for (const auto &file : partition->getSourceHeaderCppOutputFiles()) {
+				addGenerateTask(partition.get(), cppGeneratorFactory, file.get());
+			}
+			for (const auto &file : partition->getCsPartOutputFiles()) {
+				addGenerateTask(partition.get(), csGeneratorFactory, file.get());
+			}
+		}
+		tasks.waitUntilEmpty();
+
+		for (const auto &fileErrorList : fileErrorLists) {
+			errorList->addAll(fileErrorList.get());
+		}
+
+		if (!errorList->hasErrors()) {
+			removeStaleGeneratedFiles();
+		}
+
+		if (app->outputManifest && !config->dryRunMode) {
+			// The fingerprints are stored only if all the files were generated successfully, otherwise they are regenerated on the next round.
+			map<string, Hash128> fingerprints;
+			if (!errorList->hasErrors()) {
+				for (const auto &partition : partitions) {
+					fingerprints[partition->getName()] = partition->getFingerprint();
+				}
+			}
+			app->outputManifest->setPartitionFingerprints(fingerprints);
+			app->outputManifest->removeEntriesNotUsedInCurrentRound();
+			app->outputManifest->saveIfModified();
+		}
+	}
+}
+
+void CppProject::removeStaleGeneratedFiles(const Path &dir, const string &extension, const vector<shared_ptr<CppOutputFile>> &currentFiles) {
+	if (dir.empty() || !exists(dir.path())) return;
+
+	string autogeneratedFileCommentLine = sb() << "// " << OutputFileGenerator::getAutogeneratedFileComment(config);
+	set<string> currentFilePaths;
+	for (const auto &file : currentFiles) {
+		currentFilePaths.insert(file->file.toString());
+	}
+
+	vector<Path> dirs = { dir };
+	vector<Path> staleFiles;
+	for (const auto &entry : filesystem::recursive_directory_iterator(dir.path())) {
+		Path path = entry.path();
+		if (entry.is_directory()) {
+			dirs.push_back(path);
+		}
+		else if (entry.is_regular_file() && entry.path().extension() == extension && !contains(currentFilePaths, path.toString())) {
+			// Don't remove files that were not generated by this tool, even if they are in the generated directory.
+			string firstLine;
+			{
+				ifstream in(path.path(), ios::binary);
+				getline(in, firstLine);
+			}
+			if (boost::starts_with(firstLine, "\xEF\xBB\xBF")) firstLine.erase(0, 3);
+			if (boost::starts_with(firstLine, autogeneratedFileCommentLine)) {
+				staleFiles.push_back(path);
+			}
+		}
+	}
+
+	for (const Path &path : staleFiles) {
+		if (config->dryRunMode) {
+			LOG_ERROR(sb() << "Would remove stale auto-generated file if dry-run mode was not enabled: " << path);
+		}
+		else {
+			filesystem::remove(path.path());
+			LOG_INFO(sb() << "Removed stale auto-generated file: " << path);
+		}
+	}
+
+	// Remove the directories that became empty, deepest first.
+	if (!config->dryRunMode) {
+		for (auto iter = dirs.rbegin(); iter != dirs.rend(); ++iter) {
+			if (filesystem::is_empty(iter->path())) {
+				filesystem::remove(iter->path());
+			}
+		}
+	}
+}
+
+void CppProject::removeStaleGeneratedFiles() {
+	for (const auto &partition : partitions) {
+		removeStaleGeneratedFiles(partition->getSourceHeaderCppOutputDir(), ".cpp", partition->getSourceHeaderCppOutputFiles());
+		removeStaleGeneratedFiles(partition->getCsPartOutputDir(), ".cs", partition->getCsPartOutputFiles());
+	}
+}
+
+void CppProject::addParseTask(ThreadPool::TaskSet *tasks, const vector<shared_ptr<CppParsedFile>> &parsedFiles) {
+	{
+		lock_guard<mutex> _(parseStatisticsLock);
+		parseStatistics.numParseTasks++;
+	}
+	{
+		PendingParseTask pendingTask;
+		for (const auto &parsedFile : parsedFiles) {
+			pendingTask.size += parsedFile->file->fileSize;
+		}
+		pendingTask.parsedFiles = parsedFiles;
+		lock_guard<mutex> _(pendingParseTasksLock);
+		pendingParseTasks.push(move(pendingTask));
+	}
+
+	// There is one pool task per pending task, but the pool task doesn't necessarily parse the files it was added for.
+	tasks->addTask([this]() {
+		double startTime = getTimeSeconds();
+		PendingParseTask pendingTask;
+		{
+			lock_guard<mutex> _(pendingParseTasksLock);
+			if (pendingParseTasks.empty()) EXC("No pending parse task for a parse task");
+			pendingTask = pendingParseTasks.top();
+			pendingParseTasks.pop();
+		}
+		for (const auto &parsedFile : pendingTask.parsedFiles) {
+			errorList->runWithExceptionCheck([&] {
+				CppFileParser::parseFile(parsedFile.get(), config, app->parseCache.get());
+			});
+		}
+		double endTime = getTimeSeconds();
+		double seconds = endTime - startTime;
+
+		lock_guard<mutex> _(parseStatisticsLock);
+		parseStatistics.parseTaskSeconds += seconds;
+		parseStatistics.longestParseTaskSeconds = max(parseStatistics.longestParseTaskSeconds, seconds);
+		if (firstParseTaskStartTime < 0 || startTime < firstParseTaskStartTime) firstParseTaskStartTime = startTime;
+		lastParseTaskEndTime = max(lastParseTaskEndTime, endTime);
+	});
+}
+
+void CppProject::findAndParseSourceFiles() {
+	int numThreads = app->threadPool->getNumThreads();
+
+	// The files are parsed while the directories are still being scanned: large files in tasks of their own as soon as they are found,
+	// and small files in batches whose size grows with the total size found so far (the final total is not known until the scan ends).
+	ThreadPool::TaskSet scanTasks(app->threadPool.get());
+	ThreadPool::TaskSet parseTasks(app->threadPool.get());
+	mutex batchLock;
+	vector<shared_ptr<CppParsedFile>> batch;
+	int64_t batchSize = 0;
+	int64_t totalSizeFound = 0;
+	errorList->runWithExceptionCheck([&] {
 		for (const auto &partition : partitions) {
-			auto updateFile = [&](OutputFileGenerator &&generator) {
-				generator.init(partition.get(), mainPartition.get());
-				
-				CppOutputFile *outputFile = generator.getOutputFile();
-				if (outputFile && !outputFile->file.empty()) {
-					StopWatch fileStopWatch = app->createStopWatchForPerformanceMeasurement();
-					shared_ptr<StringBuilder> output = make_shared<StringBuilder>();
-					generator.generateOutput(*output);
-					fileStopWatch.mark("output / generate");
-					generator.updateGeneratedUtf8FileIfModified(outputFile->file, output->buffer.data(), output->buffer.size(), outputFile->shouldWriteByteOrderMark, shouldUseCrLfLineBreaks, config->dryRunMode);
-					fileStopWatch.mark("output / update file");
+			partition->startFindSourceFiles(&scanTasks, [&](const shared_ptr<CppParsedFile> &parsedFile) {
+				int64_t fileSize = parsedFile->file->fileSize;
+				if (fileSize >= maxParseBatchSize) {
+					addParseTask(&parseTasks, { parsedFile });
+					return;
 				}
-			};
 
-			updateFile(HeaderOutputGenerator());
-			updateFile(CppOutputGenerator());
-			updateFile(CsOutputGenerator());
-			updateFile(HlslOutputGenerator());
-			updateFile(GlslOutputGenerator());
+				vector<shared_ptr<CppParsedFile>> fullBatch;
+				{
+					lock_guard<mutex> _(batchLock);
+					totalSizeFound += fileSize;
+					batch.push_back(parsedFile);
+					batchSize += fileSize;
+					int64_t targetBatchSize = min(maxParseBatchSize, totalSizeFound / (numThreads * numParseBatchesPerThread));
+					if (batchSize >= targetBatchSize) {
+						fullBatch.swap(batch);
+						batchSize = 0;
+					}
+				}
+				if (!fullBatch.empty()) {
+					addParseTask(&parseTasks, fullBatch);
+				}
+			});
 		}
+	});
+	// Must wait even if there were errors, because the tasks refer to the task sets.
+	scanTasks.waitUntilEmpty();
+
+	if (!errorList->hasErrors() && !batch.empty()) {
+		addParseTask(&parseTasks, batch);
+	}
+	parseTasks.waitUntilEmpty();
+
+	parseStatistics.numParseThreads = numThreads + 1; // The thread waiting for the tasks runs them too.
+	parseStatistics.parseWallSeconds = (firstParseTaskStartTime < 0) ? 0 : lastParseTaskEndTime - firstParseTaskStartTime;
+	if (errorList->hasErrors()) return;
+
+	for (const auto &partition : partitions) {
+		partition->finishFindSourceFiles();
 	}
 }
 
 CppStatistics CppProject::calculateTotalStatistics() {
 	CppStatistics stats;
+	stats.add(&parseStatistics);
 	for (const auto &m : partitions) {
 		stats.add(m->getStatistics());
 	}
@@ -178,37 +440,18 @@ void CppProject::processProject() {
 	stopWatch.mark("init");
 	if (errorList->hasErrors()) return;
 
-	LOG_DETAIL("Finding source files");
-	{
-		ThreadPool::TaskSet tasks(app->threadPool.get());
-		for (const auto &partition : partitions) {
-			partition->startFindSourceFiles(&tasks);
-		}
-		tasks.waitUntilEmpty();
-
-		for (const auto &partition : partitions) {
-			partition->finishFindSourceFiles();
-		}
-	}
-	stopWatch.mark("find source files");
+	LOG_DETAIL("Finding and parsing source files");
+	findAndParseSourceFiles();
+	stopWatch.mark("find and parse source files");
 	if (errorList->hasErrors()) return;
 
-	LOG_DETAIL("Parsing input files");
-	{
-		ThreadPool::TaskSet tasks(app->threadPool.get());
-		for (const auto &partition : partitions) {
-			partition->forEachParsedFile([&](const shared_ptr<CppParsedFile> &parsedFile) {
-				tasks.addTask([this, parsedFile]() {
-					errorList->runWithExceptionCheck([&] {
-						CppFileParser::parseFile(parsedFile.get(), config);
-					});
-				});
-			});
+	if (app->parseCache) {
+		app->parseCache->removeEntriesNotUsedInCurrentRound();
+		if (!config->dryRunMode) {
+			app->parseCache->saveIfModified();
 		}
-		tasks.waitUntilEmpty();
+		stopWatch.mark("read source files / update parse cache");
 	}
-	stopWatch.mark("read source files / parseFile");
-	if (errorList->hasErrors()) return;
 
 	for (const auto &partition : partitions) {
 		partition->forEachParsedFile([&](const shared_ptr<CppParsedFile> &parsedFile) {
@@ -221,6 +464,24 @@ void CppProject::processProject() {
 	stopWatch.mark("read source files / apply file");
 	if (errorList->hasErrors()) return;
 
+	for (const auto &partition : partitions) {
+		partition->initSourceHeaderCppOutputFiles();
+		partition->initCsPartOutputFiles();
+	}
+
+	// Linking cannot be skipped for individual partitions, because the classes of one partition may be needed when linking the others.
+	if (checkWhichPartitionsAreUpToDate()) {
+		stopWatch.mark("check partition fingerprints");
+		LOG_DETAIL("All partitions are up-to-date according to output manifest, skipping linking and output");
+		parseStatistics.linkingSkipped = true;
+		if (!config->dryRunMode) {
+			app->outputManifest->removeEntriesNotUsedInCurrentRound();
+			app->outputManifest->saveIfModified();
+		}
+		return;
+	}
+	stopWatch.mark("check partition fingerprints");
+
 	// Link the source files together and resolve type dependencies.
 	LOG_DETAIL("Linking");
 	linkParsedFiles();
@@ -4,16 +4,42 @@
 class CppProject {
 	Config *config = nullptr;
 	ErrorList *errorList = nullptr;
+	// Owns the classes, functions, type mappings etc. of the project model, which refer to each other with plain pointers.
+	// Declared first so that it is destroyed last.
+	Arena arena;
 	shared_ptr<TypeMap> typeMap;
 
 	unordered_set<string> outputDirs;
 	unordered_map<string, shared_ptr<CppPartition>> partitionsByName;
 	vector<shared_ptr<CppPartition>> partitions;
-	unordered_map<string, shared_ptr<CppClass>> classesByName;
+	unordered_map<string, CppClass *> classesByName;
 	set<string> usedCppGlobalIdentifiers;
 	LineBreakCounts lineBreakCountsInSource;
+	mutex parseStatisticsLock;
+	CppStatistics parseStatistics;
+	double firstParseTaskStartTime = -1; // The parse time excludes the scanning that happens before the first file is found.
+	double lastParseTaskEndTime = -1;
 	bool processed = false;
 
+	// The files/batches waiting to be parsed. Each parse task takes the largest one when it starts, so that the largest files are parsed first
+	// (which minimizes the time the last ones take) even if they are found late in the scan, and regardless of the order of the pool's queues.
+	struct PendingParseTask {
+		int64_t size = 0;
+		vector<shared_ptr<CppParsedFile>> parsedFiles;
+
+		bool operator<(const PendingParseTask &other) const { return size < other.size; }
+	};
+	mutex pendingParseTasksLock;
+	priority_queue<PendingParseTask> pendingParseTasks;
+
+	// Small files are parsed in batches that amortize the per-task overhead. The batch size is derived from the number of bytes found so far
+	// so that there are several batches per thread, but at most maxParseBatchSize bytes per batch. Larger files are parsed in tasks of their own.
+	static constexpr int64_t maxParseBatchSize = 256 * 1024;
+	static constexpr int64_t numParseBatchesPerThread = 4;
+
+	void addParseTask(ThreadPool::TaskSet *tasks, const vector<shared_ptr<CppParsedFile>> &parsedFiles);
+	void findAndParseSourceFiles();
+
 public:
 	explicit CppProject(Config *config, ErrorList *errorList);
 	DISABLE_COPY_AND_MOVE(CppProject);
@@ -22,23 +48,33 @@ public:
 	Config * getConfig() { return config; }
 	ErrorList * getErrorList() { return errorList; }
 	TypeMap * getTypeMap() { return typeMap.get(); }
+	Arena * getArena() { return &arena; }
 
 	bool isFileInsideAnyOutputDir(const string &path);
+	bool isSourceHeaderFileUsed(const string &path); // True if the file is a header with exported elements in any partition.
 	void checkFileNotInsideAnotherPartition(const Path &path, CppPartition *partition);
 	
-	// Appends a number to the generated class/function name in case there would be multiple classes/functions with the same name
+	// Appends a number to the generated class/function name in case there would be multiple classes/functions with the same name.
+	// Not thread-safe: the identifiers are reserved before the output files are generated (see CppPartition::reserveGeneratedIdentifiers()).
 	string reserveCppGlobalIdentifier(const string &basename);
 
 	shared_ptr<CppPartition> createPartitionIfDoesNotExist(const Config::Partition &partitionConfig);
 
-	bool addClassIfDoesNotExist(shared_ptr<CppClass> clazz, CppPartition *partition);
-	shared_ptr<CppClass> getClassByCppNameIfExists(const string &cppName);
+	bool addClassIfDoesNotExist(CppClass *clazz, CppPartition *partition);
+	CppClass * getClassByCppNameIfExists(const string &cppName);
 	void addClassDependency(CppClass *dependent, CppClass *dependee);
 
 	void applyFileParseResult(shared_ptr<CppParsedFile> parsedFile, CppPartition *partition);
 
 	void linkParsedFiles();
+	bool shouldUseCrLfLineBreaks();
+	// Calculates the fingerprints of the partitions and returns true if none of the output files need to be generated.
+	bool checkWhichPartitionsAreUpToDate();
 	void generateOutputFiles();
+	// Removes the files in the generated subdirectories of a partition that are no longer generated (see Config::generateCppFilePerSourceHeader
+	// and Config::csOutputSplitMode).
+	void removeStaleGeneratedFiles(const Path &dir, const string &extension, const vector<shared_ptr<CppOutputFile>> &currentFiles);
+	void removeStaleGeneratedFiles();
 	CppStatistics calculateTotalStatistics();
 	void processProject();
 
@@ -1,7 +1,8 @@
 #include "pch.h"
 
 
-void CppSourceDirectory::initByScanningDirectoryForSourceFilesRecursivelyAndConcurrently(const Path &baseDir, const Path &relativeDir, FileSet *fileSet, ThreadPool::TaskSet *taskSet, ErrorList *errorList) {
+void CppSourceDirectory::initByScanningDirectoryForSourceFilesRecursivelyAndConcurrently(const Path &baseDir, const Path &relativeDir, FileSet *fileSet, ThreadPool::TaskSet *taskSet, ErrorList *errorList,
+	const function<void(const shared_ptr<CppFile> &)> &fileFoundCallback) {
 	subdirs.clear();
 	files.clear();
 
@@ -24,9 +25,8 @@ void CppSourceDirectory::initByScanningDirectoryForSourceFilesRecursivelyAndConc
 		}
 		else {
 			if (!fileSet || fileSet->isPathInSet(relativePathString)) {
-				string extensionLowerCase = boost::algorithm::to_lower_copy(Path(filenameString).path().extension().string());
-				bool isHeaderFile = (extensionLowerCase == ".h" || extensionLowerCase == ".hpp");
-				bool isSourceFile = (extensionLowerCase == ".c" || extensionLowerCase == ".cpp" || extensionLowerCase == ".cxx" || extensionLowerCase == ".cc");
+				bool isHeaderFile = isHeaderFileName(filenameString);
+				bool isSourceFile = isSourceFileName(filenameString);
 				if (isHeaderFile || isSourceFile) {
 					
 					filesByName[relativePathString] = make_shared<CppFile>((baseDir / relativePath).toString(), entry.file_size(), entry.last_write_time().time_since_epoch().count(), isHeaderFile);
@@ -37,6 +37,9 @@ void CppSourceDirectory::initByScanningDirectoryForSourceFilesRecursivelyAndConc
 
 	for (auto &entry : filesByName) {
 		files.push_back(entry.second);
+		if (fileFoundCallback) {
+			fileFoundCallback(entry.second);
+		}
 	}
 
 	for (const string &path : directories) {
@@ -46,7 +49,7 @@ void CppSourceDirectory::initByScanningDirectoryForSourceFilesRecursivelyAndConc
 
 		auto task = [=] {
 			errorList->runWithExceptionCheck([&] {
-				subdir->initByScanningDirectoryForSourceFilesRecursivelyAndConcurrently(baseDir, Path(path), fileSet, taskSet, errorList);
+				subdir->initByScanningDirectoryForSourceFilesRecursivelyAndConcurrently(baseDir, Path(path), fileSet, taskSet, errorList, fileFoundCallback);
 			});
 		};
 		
@@ -59,6 +62,20 @@ void CppSourceDirectory::initByScanningDirectoryForSourceFilesRecursivelyAndConc
 	}
 }
 
+static string getFileExtensionInLowerCase(const string &filename) {
+	return boost::algorithm::to_lower_copy(Path(filename).path().extension().string());
+}
+
+bool CppSourceDirectory::isHeaderFileName(const string &filename) {
+	string extensionLowerCase = getFileExtensionInLowerCase(filename);
+	return extensionLowerCase == ".h" || extensionLowerCase == ".hpp";
+}
+
+bool CppSourceDirectory::isSourceFileName(const string &filename) {
+	string extensionLowerCase = getFileExtensionInLowerCase(filename);
+	return extensionLowerCase == ".c" || extensionLowerCase == ".cpp" || extensionLowerCase == ".cxx" || extensionLowerCase == ".cc";
+}
+
 void CppSourceDirectory::forEachFileRecursively(const function<void(const shared_ptr<CppFile> &)> &f) {
 	for (const shared_ptr<CppFile> &file : files) {
 		f(file);
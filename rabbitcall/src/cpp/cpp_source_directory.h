@@ -4,7 +4,12 @@ struct CppSourceDirectory {
 	vector<shared_ptr<CppSourceDirectory>> subdirs;
 	vector<shared_ptr<CppFile>> files;
 
-	void initByScanningDirectoryForSourceFilesRecursivelyAndConcurrently(const Path &baseDir, const Path &relativeDir, FileSet *fileSet, ThreadPool::TaskSet *taskSet, ErrorList *errorList);
+	// The callback is invoked (possibly concurrently) for each file as soon as it has been found, e.g. so that it can be parsed while the scanning continues.
+	void initByScanningDirectoryForSourceFilesRecursivelyAndConcurrently(const Path &baseDir, const Path &relativeDir, FileSet *fileSet, ThreadPool::TaskSet *taskSet, ErrorList *errorList,
+		const function<void(const shared_ptr<CppFile> &)> &fileFoundCallback);
 	void forEachFileRecursively(const function<void(const shared_ptr<CppFile> &)> &f);
+
+	static bool isHeaderFileName(const string &filename);
+	static bool isSourceFileName(const string &filename);
 };
 
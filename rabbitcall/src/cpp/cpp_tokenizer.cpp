@@ -69,45 +69,28 @@ string CppSourceCodeView::getSimplifiedCode() const {
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-CppSourceCodeBuffer::CppSourceCodeBuffer(const void *data, int64_t dataSize, int64_t startFileOffset, CppFile *file) {
-	buffer = allocateMemory(dataSize);
-	memcpy(buffer, data, dataSize);
-	sourceCode = CppSourceCodeView(buffer, dataSize, startFileOffset, file);
-}
-
-CppSourceCodeBuffer::CppSourceCodeBuffer(const CppSourceCodeView &sourceCode)
-	: CppSourceCodeBuffer(sourceCode.data, sourceCode.dataSize, sourceCode.startFileOffset, sourceCode.file) {
-}
-
-CppSourceCodeBuffer::~CppSourceCodeBuffer() {
-	if (buffer) {
-		freeMemory(buffer);
-		buffer = nullptr;
-	}
-}
-
-//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
 void CppElement::invalidate() {
 	startIndex = CppElementIndex();
 	endIndex = CppElementIndex();
 	type = CppElementType::INVALID;
+	keyword = CppKeyword::NONE;
 	ch = 0;
-	text.clear();
+	text = StringView();
 }
 
 string CppElement::getText() {
-	if (!text.empty()) return text;
+	if (!text.empty()) return text.toString();
 	if (ch != '\0') return string(&ch, 1);
 	return "";
 }
 
-void CppElement::handleIdentifier(const CppElementIndex &startIndex, const CppElementIndex &endIndex, const char *ptr, int64_t length) {
+void CppElement::handleIdentifier(const CppElementIndex &startIndex, const CppElementIndex &endIndex, const char *ptr, int64_t length, CppKeyword keyword) {
 	invalidate();
 	type = CppElementType::IDENTIFIER;
 	this->startIndex = startIndex;
 	this->endIndex = endIndex;
-	text = string(ptr, length);
+	this->keyword = keyword;
+	text = StringView(ptr, length);
 }
 
 void CppElement::handleSpecialChar(const CppElementIndex &startIndex, const CppElementIndex &endIndex, char ch) {
@@ -136,7 +119,16 @@ void CppCommentMap::addCommentIfNotInAlreadyParsedRegion(int64_t startOffset, in
 
 unique_ptr<CppTokenizerTables> CppTokenizerTables::instance;
 
-void CppTokenizerTables::init() {
+void CppTokenizerTables::addKeyword(const string &text, CppKeyword keyword) {
+	if (text.empty()) EXC("Keyword cannot be empty");
+	vector<KeywordEntry> &entries = keywordsByFirstChar.at((uint8_t)text.at(0));
+	for (const KeywordEntry &entry : entries) {
+		if (entry.text == text) EXC(sb() << "Keyword defined twice (export keyword in configuration cannot be a C++ keyword): " << text);
+	}
+	entries.push_back(KeywordEntry { text, keyword });
+}
+
+void CppTokenizerTables::init(const string &exportKeyword, const string &exportKeywordWithParameters) {
 
 	int tableSize = 256;
 	handlersByCharType.resize(tableSize);
@@ -168,6 +160,30 @@ void CppTokenizerTables::init() {
 	setCharTypeFlagHandler(CppCharType::FLAG_LETTER_OR_UNDERSCORE, &CppTokenizer::handleChar_letterOrUnderscore);
 	setCharTypeFlagHandler(CppCharType::FLAG_DIGIT, &CppTokenizer::handleChar_digit);
 
+	keywordsByFirstChar.resize(256);
+	addKeyword("class", CppKeyword::CLASS);
+	addKeyword("struct", CppKeyword::STRUCT);
+	addKeyword("enum", CppKeyword::ENUM);
+	addKeyword("union", CppKeyword::UNION);
+	addKeyword("typedef", CppKeyword::TYPEDEF);
+	addKeyword("using", CppKeyword::USING);
+	addKeyword("namespace", CppKeyword::NAMESPACE);
+	addKeyword("virtual", CppKeyword::VIRTUAL);
+	addKeyword("public", CppKeyword::PUBLIC);
+	addKeyword("protected", CppKeyword::PROTECTED);
+	addKeyword("private", CppKeyword::PRIVATE);
+	addKeyword("alignas", CppKeyword::ALIGNAS);
+	addKeyword("static", CppKeyword::STATIC);
+	addKeyword("noexcept", CppKeyword::NOEXCEPT);
+	addKeyword("const", CppKeyword::CONST);
+	addKeyword("volatile", CppKeyword::VOLATILE);
+	addKeyword("operator", CppKeyword::OPERATOR);
+	addKeyword("new", CppKeyword::OPERATOR_NEW);
+	addKeyword("delete", CppKeyword::OPERATOR_DELETE);
+	addKeyword("co_await", CppKeyword::OPERATOR_CO_AWAIT);
+	addKeyword(exportKeyword, CppKeyword::EXPORT);
+	addKeyword(exportKeywordWithParameters, CppKeyword::EXPORT_WITH_PARAMETERS);
+
 	initialized = true;
 }
 
@@ -187,8 +203,8 @@ CppTokenizer::CppTokenizer(const CppSourceCodeView &sourceCode, const CppElement
 	}
 }
 
-string CppTokenizer::getDataRangeAsString(int64_t startPos, int64_t endPos) {
-	return string((const char *)getData() + startPos, endPos - startPos);
+StringView CppTokenizer::getDataRange(int64_t startPos, int64_t endPos) {
+	return StringView((const char *)getData() + startPos, endPos - startPos);
 }
 
 void CppTokenizer::setBlockDepthLimit(int limit) {
@@ -203,10 +219,10 @@ int CppTokenizer::setBlockDepthLimitToCurrentBlockAndGetOldLimit() {
 
 void CppTokenizer::skipUntil(const char *s) {
 	int64_t length = strlen(s);
-	while (getRemainingSize() >= length) {
-		if (memcmp(getData() + currentIndex.pos, s, length) == 0) break;
-		currentIndex.pos++;
-	}
+	int64_t pos = findByteSequence(getData(), getDataSize(), s, length, currentIndex.pos);
+
+	// If not found, stop where the remaining data is too short to contain the string.
+	currentIndex.pos = (pos >= 0 ? pos : max(currentIndex.pos, getDataSize() - length + 1));
 }
 
 bool CppTokenizer::trySkipLineBreakAfterBackslash() {
@@ -282,7 +298,7 @@ void CppTokenizer::skipUntilPreprocessorDirective(const string &directive) {
 					char ch2 = getData()[currentIndex.pos++];
 					if (cppParseUtil->isLetterOrUnderscore(ch2)) {
 						skipIdentifierChars();
-						string identifier = getDataRangeAsString(identifierStartPos, currentIndex.pos);
+						StringView identifier = getDataRange(identifierStartPos, currentIndex.pos);
 						if (identifier == directive) {
 							skipUntilLineBreak(false);
 							return;
@@ -295,14 +311,22 @@ void CppTokenizer::skipUntilPreprocessorDirective(const string &directive) {
 }
 
 void CppTokenizer::skipUntilLineBreak(bool shouldSkipLineBreakToo) {
-	while (!isFinished()) {
+	// Only backslashes and line-breaks need to be handled, and the rest are skipped with a vectorized search.
+	const ByteSet &specialChars = CppTokenizerTables::instance->getLineBreakSpecialChars();
+	while (true) {
+		int64_t pos = findFirstByteInSet(getData(), getDataSize(), specialChars, currentIndex.pos);
+		if (pos < 0) {
+			currentIndex.pos = max(currentIndex.pos, getDataSize());
+			return;
+		}
+		currentIndex.pos = pos;
 		char ch = readChar();
 		if (ch != '\\' || !trySkipLineBreakAfterBackslash()) {
 			if (ch == '\n') {
 				if (!shouldSkipLineBreakToo) {
 					currentIndex.pos--;
 				}
-				break;
+				return;
 			}
 			else if (ch == '\r' && currentIndex.pos + 1 < getDataSize() && getData()[currentIndex.pos + 1] == '\n') {
 				if (shouldSkipLineBreakToo) {
@@ -311,7 +335,7 @@ void CppTokenizer::skipUntilLineBreak(bool shouldSkipLineBreakToo) {
 				else {
 					currentIndex.pos--;
 				}
-				break;
+				return;
 			}
 		}
 	}
@@ -341,14 +365,13 @@ CppStringLiteralType CppTokenizer::parseStringLiteralTypePrefix(const StringView
 
 bool CppTokenizer::readStringLiteral(const CppStringLiteralType &type) {
 	bool isRaw = type.isValid && type.isRaw;
-	string rawStringDelimiter;
+	StringView rawStringDelimiter; // The delimiter between the quote and the parenthesis, which must be repeated between the closing parenthesis and quote.
 	if (isRaw) {
 		int64_t delimiterStart = currentIndex.pos;
 		while (!isFinished()) {
 			char ch = readChar();
 			if (ch == '(') {
-				rawStringDelimiter += string((const char *)getData() + delimiterStart, currentIndex.pos - 1 - delimiterStart);
-				rawStringDelimiter += "\"";
+				rawStringDelimiter = getDataRange(delimiterStart, currentIndex.pos - 1);
 				break;
 			}
 			if (ch == '\"') return false;
@@ -356,40 +379,66 @@ bool CppTokenizer::readStringLiteral(const CppStringLiteralType &type) {
 		//LOG_DEBUG(sb() << "Raw string delimiter: " << rawStringDelimiter);
 	}
 	
-	// Scan until a closing quote if found so that also raw string literals are skipped.
-	// A non-raw string literal should not continue until a line-break (unless it is preceded by a backslash),
-	// but don't raise an error if it does (the compiler should).
-	while (!isFinished()) {
-		char ch = readChar();
-		if (isRaw) {
-			if (ch == ')' && getRemainingSize() >= (int64_t)rawStringDelimiter.size() && memcmp(rawStringDelimiter.data(), getData() + currentIndex.pos, rawStringDelimiter.size()) == 0) {
-				//LOG_DEBUG(sb() << "Raw string: " << string((const char *)getData() + startPos, currentIndex.pos - startPos - 1));
-				currentIndex.pos += rawStringDelimiter.size();
+	if (isRaw) {
+		// The raw string literal ends at the first closing parenthesis that is followed by the delimiter and a quote. To avoid building
+		// the end sequence for each literal, the delimiter is searched directly from the source buffer (where rawStringDelimiter points to)
+		// and the parenthesis and quote around it are checked separately.
+		const uint8_t *data = getData();
+		int64_t dataSize = getDataSize();
+		if (rawStringDelimiter.empty()) {
+			int64_t endPos = findByteSequence(data, dataSize, ")\"", 2, currentIndex.pos);
+			currentIndex.pos = (endPos >= 0 ? endPos + 2 : dataSize);
+			return false;
+		}
+
+		int64_t searchPos = currentIndex.pos + 1;
+		while (true) {
+			int64_t delimiterPos = findByteSequence(data, dataSize, rawStringDelimiter.ptr, rawStringDelimiter.length, searchPos);
+			if (delimiterPos < 0) {
+				currentIndex.pos = dataSize;
+				break;
+			}
+			int64_t quotePos = delimiterPos + rawStringDelimiter.length;
+			if (data[delimiterPos - 1] == ')' && quotePos < dataSize && data[quotePos] == '\"') {
+				currentIndex.pos = quotePos + 1;
 				break;
 			}
+			searchPos = delimiterPos + 1;
 		}
-		else {
-			if (ch == '\\') {
-				if (trySkipLineBreakAfterBackslash()) {
+		return false;
+	}
+
+	// Scan until a closing quote. A non-raw string literal should not continue until a line-break (unless it is preceded by a backslash),
+	// but don't raise an error if it does (the compiler should). Other characters than these are skipped with a vectorized search.
+	const ByteSet &specialChars = CppTokenizerTables::instance->getStringLiteralSpecialChars();
+	while (true) {
+		int64_t pos = findFirstByteInSet(getData(), getDataSize(), specialChars, currentIndex.pos);
+		if (pos < 0) {
+			currentIndex.pos = max(currentIndex.pos, getDataSize());
+			break;
+		}
+		currentIndex.pos = pos;
+		char ch = readChar();
+		if (ch == '\\') {
+			if (trySkipLineBreakAfterBackslash()) {
+			}
+			else if (!isFinished()) {
+				if (peekChar() == '\"') { // Escaped quote.
+					currentIndex.pos++;
 				}
-				else if (!isFinished()) {
-					if (peekChar() == '\"') { // Escaped quote.
-						currentIndex.pos++;
-					}
-					else if (peekChar() == '\\') { // Escaped backslash.
-						currentIndex.pos++;
-					}
+				else if (peekChar() == '\\') { // Escaped backslash.
+					currentIndex.pos++;
 				}
 			}
-			else if (ch == '\r' || ch == '\n') {
-				// Line-breaks are not allowed in the middle of a string literal, but there is some code that has e.g. erroneous string literals inside #if blocks
-				// that are only visited in error situations and have therefore gone undetected => be lenient and interpret that the string ends at the line-break.
-				currentIndex.pos--;
-				break;
-			}
-			else if (ch == '\"') {
-				break;
-			}
+		}
+		else if (ch == '\r' || ch == '\n') {
+			// Line-breaks are not allowed in the middle of a string literal, but there is some code that has e.g. erroneous string literals inside #if blocks
+			// that are only visited in error situations and have therefore gone undetected => be lenient and interpret that the string ends at the line-break.
+			currentIndex.pos--;
+			break;
+		}
+		else { // Closing quote.
+			break;
 		}
 	}
 	return false; // String literals are currently only skipped, not handled as elements.
@@ -416,7 +465,7 @@ bool CppTokenizer::readPreprocessorDirective() {
 		if (cppParseUtil->isLetterOrUnderscore(ch2)) {
 			currentIndex.pos++;
 			skipIdentifierChars();
-			string identifier = getDataRangeAsString(identifierStartPos, currentIndex.pos);
+			StringView identifier = getDataRange(identifierStartPos, currentIndex.pos);
 
 			if (identifier == "else" || identifier == "elif") {
 				// Skip #else and #elif blocks because they might contain e.g. opening braces that should be alternative to the one defined in the main #if block,
@@ -431,6 +480,43 @@ bool CppTokenizer::readPreprocessorDirective() {
 	return false; // Preprocessor directive not currently handled as an element.
 }
 
+bool CppTokenizer::isPreprocessorDirectiveAllowedAfterPlainCode(int64_t pos, int64_t plainCodeStartPos, bool allowedAtPlainCodeStart) {
+	// Scan backwards over white-space until the previous line-break (a line-break preceded by a backslash does not count) or other code is found.
+	const uint8_t *data = getData();
+	int64_t i = pos - 1;
+	while (i >= plainCodeStartPos) {
+		char ch = data[i];
+		if (ch == '\n') {
+			if (i - 1 >= plainCodeStartPos && data[i - 1] == '\\') {
+				i -= 2;
+			}
+			else if (i - 2 >= plainCodeStartPos && data[i - 1] == '\r' && data[i - 2] == '\\') {
+				i -= 3;
+			}
+			else {
+				return true;
+			}
+		}
+		else if (cppParseUtil->isHorizontalSpace(ch) || ch == '\r') { // A CR without an LF is ignored by the tokenizer.
+			i--;
+		}
+		else {
+			return false;
+		}
+	}
+	return allowedAtPlainCodeStart;
+}
+
+CppStringLiteralType CppTokenizer::getStringLiteralTypeBeforeQuote(int64_t quotePos, int64_t plainCodeStartPos) {
+	// Find the identifier immediately before the quote. Leading digits are not part of it, because the tokenizer reads each digit as a separate element.
+	const uint8_t *data = getData();
+	int64_t prefixStartPos = quotePos;
+	while (prefixStartPos > plainCodeStartPos && cppParseUtil->isLetterOrUnderscoreOrDigit(data[prefixStartPos - 1])) prefixStartPos--;
+	while (prefixStartPos < quotePos && cppParseUtil->isDigit(data[prefixStartPos])) prefixStartPos++;
+	if (prefixStartPos == quotePos) return CppStringLiteralType();
+	return parseStringLiteralTypePrefix(getDataRange(prefixStartPos, quotePos));
+}
+
 bool CppTokenizer::handleChar_unknown(CppElement *resultElement, const CppElementIndex &startIndex, char ch) {
 	if (currentIndex.isCurrentLinePreprocessorDirective) return false;
 	currentIndex.isPreprocessorDirectiveAllowedAtCurrentPos = false;
@@ -509,7 +595,7 @@ bool CppTokenizer::handleChar_letterOrUnderscore(CppElement *resultElement, cons
 		}
 	}
 	
-	resultElement->handleIdentifier(startIndex, currentIndex, startPtr, length);
+	resultElement->handleIdentifier(startIndex, currentIndex, startPtr, length, CppTokenizerTables::instance->getKeyword(startPtr, length));
 	return true;
 }
 
@@ -558,6 +644,94 @@ void CppTokenizer::readNextElement(CppElement *element) {
 	}
 }
 
+bool CppTokenizer::trySkipToEndOfBlock(int64_t stopPos) {
+	// Only the characters that can affect block nesting are handled (by the same functions that the element handlers use), and the rest are skipped
+	// with a vectorized search. The state of the tokenizer at the closing brace must be exactly the same as if all elements had been read.
+	CppElementIndex startIndex = currentIndex;
+	const uint8_t *data = getData();
+	int64_t dataSize = getDataSize();
+
+	const int maxNestedBlocks = 64;
+	char blockEndChars[maxNestedBlocks];
+	int numNestedBlocks = 0;
+
+	// The characters since this position have not been handled yet, because they don't affect anything else than preprocessor directives.
+	int64_t plainCodeStartPos = currentIndex.pos;
+	bool directiveAllowedAtPlainCodeStart = currentIndex.isPreprocessorDirectiveAllowedAtCurrentPos;
+
+	while (true) {
+		bool isPreprocessorDirective = currentIndex.isCurrentLinePreprocessorDirective;
+		int64_t pos = findFirstByteInSet(data, dataSize, CppTokenizerTables::instance->getBlockSkipSpecialChars(isPreprocessorDirective), currentIndex.pos);
+		if (pos < 0 || pos >= stopPos) break;
+
+		char ch = (char)data[pos];
+		currentIndex.pos = pos + 1;
+
+		if (isPreprocessorDirective) {
+			// Blocks and identifiers are ignored on preprocessor directive lines, but comments and literals are not.
+			if (ch == '\n') {
+				handleLineBreak();
+			}
+			else if (ch == '\\') {
+				trySkipLineBreakAfterBackslash();
+			}
+			else {
+				currentIndex.isPreprocessorDirectiveAllowedAtCurrentPos = false;
+				if (ch == '/') tryReadCommentAfterFirstSlashRead();
+				else if (ch == '\'') readCharLiteral();
+				else if (ch == '\"') readStringLiteral(CppStringLiteralType());
+			}
+		}
+		else {
+			bool isDirectiveAllowed = ch == '#' && isPreprocessorDirectiveAllowedAfterPlainCode(pos, plainCodeStartPos, directiveAllowedAtPlainCodeStart);
+			currentIndex.isPreprocessorDirectiveAllowedAtCurrentPos = false;
+
+			switch (ch) {
+			case '{': case '(': case '[':
+				if (numNestedBlocks == maxNestedBlocks) {
+					currentIndex = startIndex;
+					return false;
+				}
+				blockEndChars[numNestedBlocks++] = (ch == '{' ? '}' : (ch == '(' ? ')' : ']'));
+				break;
+			case '}': case ')': case ']':
+				if (numNestedBlocks == 0) {
+					if (ch != '}') {
+						currentIndex = startIndex;
+						return false;
+					}
+					currentIndex.pos = pos;
+					currentIndex.isPreprocessorDirectiveAllowedAtCurrentPos = isPreprocessorDirectiveAllowedAfterPlainCode(pos, plainCodeStartPos, directiveAllowedAtPlainCodeStart);
+					return true;
+				}
+				if (blockEndChars[--numNestedBlocks] != ch) {
+					currentIndex = startIndex;
+					return false;
+				}
+				break;
+			case '/':
+				tryReadCommentAfterFirstSlashRead();
+				break;
+			case '\'':
+				readCharLiteral();
+				break;
+			case '\"':
+				readStringLiteral(getStringLiteralTypeBeforeQuote(pos, plainCodeStartPos));
+				break;
+			case '#':
+				if (isDirectiveAllowed) readPreprocessorDirective();
+				break;
+			}
+		}
+
+		plainCodeStartPos = currentIndex.pos;
+		directiveAllowedAtPlainCodeStart = currentIndex.isPreprocessorDirectiveAllowedAtCurrentPos;
+	}
+
+	currentIndex = startIndex;
+	return false;
+}
+
 void CppTokenizer::throwParseException(int64_t errorPos, const string &msg) {
 	getSourceCode()->throwParseExceptionByRelativePos(errorPos, msg);
 }
@@ -680,6 +854,13 @@ int CppElementIterator::enterBlockAndGetOldLimit() {
 	return oldLimit;
 }
 
+int CppElementIterator::enterBlockAndTrySkipContentsAndGetOldLimit(int64_t stopPos) {
+	int oldLimit = tokenizer.setBlockDepthLimitToCurrentBlockAndGetOldLimit();
+	tokenizer.trySkipToEndOfBlock(stopPos);
+	moveToNext();
+	return oldLimit;
+}
+
 void CppElementIterator::exitBlock(int limit, char endChar, bool lenient) {
 	tokenizer.setBlockDepthLimit(limit);
 	moveToNext();
@@ -64,22 +64,6 @@ struct CppSourceCodeView {
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-class CppSourceCodeBuffer {
-
-	CppSourceCodeView sourceCode;
-	void *buffer = nullptr;
-	
-public:
-	CppSourceCodeBuffer(const void *data, int64_t dataSize, int64_t startFileOffset, CppFile *file);
-	explicit CppSourceCodeBuffer(const CppSourceCodeView &sourceCode);
-	DISABLE_COPY_AND_MOVE(CppSourceCodeBuffer);
-	~CppSourceCodeBuffer();
-
-	const CppSourceCodeView & getSourceCode() { return sourceCode; }
-};
-
-//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-
 enum class CppElementType {
 	INVALID = 0,
 	SPECIAL_CHAR,
@@ -88,18 +72,48 @@ enum class CppElementType {
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Identifiers that have a special meaning for the parser. The tokenizer looks up the keyword for each identifier so that the parser can compare them as integers.
+enum class CppKeyword : uint8_t {
+	NONE = 0,
+	CLASS,
+	STRUCT,
+	ENUM,
+	UNION,
+	TYPEDEF,
+	USING,
+	NAMESPACE,
+	VIRTUAL,
+	PUBLIC,
+	PROTECTED,
+	PRIVATE,
+	ALIGNAS,
+	STATIC,
+	NOEXCEPT,
+	CONST,
+	VOLATILE,
+	OPERATOR,
+	OPERATOR_NEW, // "new" (e.g. after the operator keyword)
+	OPERATOR_DELETE, // "delete"
+	OPERATOR_CO_AWAIT, // "co_await"
+	EXPORT, // The export keyword (FXP) defined in configuration.
+	EXPORT_WITH_PARAMETERS, // The parameterized export keyword.
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 struct CppElement {
 	CppElementIndex startIndex;
 	CppElementIndex endIndex;
 	CppElementType type = CppElementType::INVALID;
+	CppKeyword keyword = CppKeyword::NONE;
 	char ch = 0;
-	string text;
+	StringView text; // Points to the source code buffer (valid as long as the buffer is).
 
 	bool isValid() { return type != CppElementType::INVALID; }
 	void invalidate();
 	string getText();
 
-	void handleIdentifier(const CppElementIndex &startIndex, const CppElementIndex &endIndex, const char *ptr, int64_t length);
+	void handleIdentifier(const CppElementIndex &startIndex, const CppElementIndex &endIndex, const char *ptr, int64_t length, CppKeyword keyword);
 	void handleSpecialChar(const CppElementIndex &startIndex, const CppElementIndex &endIndex, char ch);
 	void handleEndOfInput(const CppElementIndex &startIndex, const CppElementIndex &endIndex);
 };
@@ -124,13 +138,41 @@ public:
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 class CppTokenizerTables {
+
+	struct KeywordEntry {
+		string text;
+		CppKeyword keyword;
+	};
+
 	vector<bool (CppTokenizer::*)(CppElement *resultElement, const CppElementIndex &startIndex, char firstChar)> handlersByCharType;
+	vector<vector<KeywordEntry>> keywordsByFirstChar;
 	bool initialized = false;
 
+	// Characters that need to be handled when skipping a block without producing elements (see CppTokenizer::trySkipToEndOfBlock()).
+	// Other characters do not affect the nesting of blocks, except for their effect on whether a preprocessor directive can start.
+	ByteSet blockSkipSpecialChars = ByteSet("{}()[]\"'/#");
+	ByteSet blockSkipSpecialCharsInPreprocessorDirective = ByteSet("\"'/\\\n");
+
+	// Characters that need to be handled when skipping until the end of a line or a string literal (others are skipped with a vectorized search).
+	ByteSet lineBreakSpecialChars = ByteSet("\\\r\n");
+	ByteSet stringLiteralSpecialChars = ByteSet("\\\r\n\"");
+
+	void addKeyword(const string &text, CppKeyword keyword);
+
 public:
-	void init();
+	void init(const string &exportKeyword, const string &exportKeywordWithParameters);
 	void checkInitialized();
 	auto getHandlerByCharType(uint8_t type) { return handlersByCharType[type]; }
+	const ByteSet & getBlockSkipSpecialChars(bool isPreprocessorDirective) { return isPreprocessorDirective ? blockSkipSpecialCharsInPreprocessorDirective : blockSkipSpecialChars; }
+	const ByteSet & getLineBreakSpecialChars() { return lineBreakSpecialChars; }
+	const ByteSet & getStringLiteralSpecialChars() { return stringLiteralSpecialChars; }
+
+	CppKeyword getKeyword(const char *ptr, int64_t length) {
+		for (const KeywordEntry &entry : keywordsByFirstChar[(uint8_t)ptr[0]]) {
+			if ((int64_t)entry.text.size() == length && memcmp(entry.text.data(), ptr, length) == 0) return entry.keyword;
+		}
+		return CppKeyword::NONE;
+	}
 
 	static unique_ptr<CppTokenizerTables> instance;
 };
@@ -165,6 +207,11 @@ class CppTokenizer {
 	bool readCharLiteral();
 	bool readPreprocessorDirective();
 
+	// Determines whether a preprocessor directive could start at the given position if the code since the given start position contains only
+	// characters that are not handled specially by trySkipToEndOfBlock() (i.e. no literals, comments or blocks).
+	bool isPreprocessorDirectiveAllowedAfterPlainCode(int64_t pos, int64_t plainCodeStartPos, bool allowedAtPlainCodeStart);
+	CppStringLiteralType getStringLiteralTypeBeforeQuote(int64_t quotePos, int64_t plainCodeStartPos);
+
 	void handleLineBreak() {
 		currentIndex.isCurrentLinePreprocessorDirective = false;
 		currentIndex.isPreprocessorDirectiveAllowedAtCurrentPos = true;
@@ -193,7 +240,7 @@ public:
 	int64_t getDataSize() { return getSourceCode()->dataSize; }
 	CppElementIndex getIndex() { return currentIndex; }
 	int64_t getRemainingSize() { return getSourceCode()->dataSize - currentIndex.pos; }
-	string getDataRangeAsString(int64_t startPos, int64_t endPos);
+	StringView getDataRange(int64_t startPos, int64_t endPos);
 	int getBlockDepthLimit() { return blockDepthLimit; }
 	void setBlockDepthLimit(int limit);
 	int setBlockDepthLimitToCurrentBlockAndGetOldLimit();
@@ -204,6 +251,11 @@ public:
 	// Returns true if an element was read, false if end-of-input reached.
 	void readNextElement(CppElement *element);
 
+	// Moves to the closing brace of the current block (the opening brace having been just read) without producing elements, so that the next
+	// element read is the same as after reading all the elements in the block. This is much faster than tokenizing e.g. function bodies.
+	// Returns false without moving if the block is not closed before the stop position or contains mismatched parentheses/brackets/braces.
+	bool trySkipToEndOfBlock(int64_t stopPos);
+
 	void throwParseException(int64_t errorPos, const string &msg);
 
 	friend class CppTokenizerTables;
@@ -243,6 +295,8 @@ struct CppElementIterator {
 	int64_t getElementStartFileOffset();
 	int64_t getElementEndFileOffset();
 	int enterBlockAndGetOldLimit();
+	// Same as enterBlockAndGetOldLimit(), but skips the contents of the block quickly if possible (see CppTokenizer::trySkipToEndOfBlock()).
+	int enterBlockAndTrySkipContentsAndGetOldLimit(int64_t stopPos);
 	void exitBlock(int limit, char endChar, bool lenient);
 };
 
@@ -0,0 +1,79 @@
+#include "pch.h"
+
+
+// Source code that consists mostly of comments, string literals and multi-line macros, like license headers and documented APIs.
+static string generateCommentDenseSourceCode(int64_t minSize) {
+	string result;
+	for (int i = 0; (int64_t)result.size() < minSize; i++) {
+		string n = to_string(i);
+		result += "/*\n"
+			" * Copyright (c) Example Corporation. All rights reserved.\n"
+			" *\n"
+			" * Permission is hereby granted, free of charge, to any person obtaining a copy of this software and associated documentation\n"
+			" * files (the \"Software\"), to deal in the Software without restriction, including without limitation the rights to use, copy,\n"
+			" * modify, merge, publish, distribute, sublicense, and/or sell copies of the Software, subject to the following conditions.\n"
+			" *\n"
+			" * THE SOFTWARE IS PROVIDED \"AS IS\", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR IMPLIED.\n"
+			" */\n"
+			"\n"
+			"/// Returns the sum of the two given values. The values may be negative, and the result is not checked for overflow,\n"
+			"/// which is the responsibility of the caller (see the documentation of the module for details).\n"
+			"/// @param a The first value.\n"
+			"/// @param b The second value.\n"
+			"int function" + n + "(int a, int b) { return a + b; } // The implementation is trivial.\n"
+			"\n"
+			"// A line comment that continues on the next line because of a backslash at the end \\\n"
+			"   of the line, which is unusual but allowed.\n"
+			"static const char *message" + n + " = \"A string literal with \\\"escaped quotes\\\" and \\\\ backslashes that is quite long.\";\n"
+			"static const char *rawMessage" + n + " = R\"delimiter(A raw string literal with ) and \" characters in it.)delimiter\";\n"
+			"#define MACRO_" + n + "(x) \\\n"
+			"\tdo { \\\n"
+			"\t\tprocess(x); /* Process the value. */ \\\n"
+			"\t} while (0)\n"
+			"\n";
+	}
+	return result;
+}
+
+// Returns the best result of several runs in bytes per cycle (or zero if cycles cannot be measured) and MB/s.
+static pair<double, double> measureTokenizerThroughput(const string &sourceCode) {
+	const int numRuns = 5;
+	double bestBytesPerCycle = 0;
+	double bestMegabytesPerSecond = 0;
+	int64_t numElements = 0;
+	for (int run = 0; run < numRuns; run++) {
+		CppCommentMap commentMap;
+		CppSourceCodeView view(sourceCode.data(), (int64_t)sourceCode.size(), 0, nullptr);
+		StopWatch stopWatch;
+		uint64_t startCycles = readCpuCycleCounter();
+
+		CppElementIterator elementIter(view, &commentMap);
+		numElements = 0;
+		while (elementIter.isValid()) {
+			numElements++;
+			elementIter.moveToNext();
+		}
+
+		uint64_t cycles = readCpuCycleCounter() - startCycles;
+		double seconds = stopWatch.getTimeAndReset();
+		if (cycles > 0) bestBytesPerCycle = max(bestBytesPerCycle, (double)sourceCode.size() / (double)cycles);
+		if (seconds > 0) bestMegabytesPerSecond = max(bestMegabytesPerSecond, (double)sourceCode.size() / seconds / 1e6);
+	}
+	LOG_DEBUG(sb() << "Tokenizer benchmark elements: " << numElements);
+	return make_pair(bestBytesPerCycle, bestMegabytesPerSecond);
+}
+
+void runTokenizerBenchmark() {
+	string sourceCode = generateCommentDenseSourceCode(16 * 1024 * 1024);
+
+	setSimdEnabled(false);
+	string scalarName = getSimdInstructionSetName();
+	pair<double, double> scalarResult = measureTokenizerThroughput(sourceCode);
+	setSimdEnabled(true);
+	string simdName = getSimdInstructionSetName();
+	pair<double, double> simdResult = measureTokenizerThroughput(sourceCode);
+
+	LOG(LogLevel::off, sb() << "Tokenizer benchmark (" << (double)sourceCode.size() / 1e6 << " MB of comment-dense code):\n"
+		<< "  " << scalarName << ": " << scalarResult.first << " bytes/cycle, " << scalarResult.second << " MB/s\n"
+		<< "  " << simdName << ": " << simdResult.first << " bytes/cycle, " << simdResult.second << " MB/s");
+}
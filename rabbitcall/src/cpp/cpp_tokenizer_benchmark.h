@@ -0,0 +1,6 @@
+#pragma once
+
+// Measures the throughput of the tokenizer on generated comment-dense source code, with and without the vectorized scanning functions,
+// and logs the results (bytes per CPU cycle and MB/s). Run with the "tokenizerBenchmark" parameter.
+void runTokenizerBenchmark();
+
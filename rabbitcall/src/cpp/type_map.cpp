@@ -1,59 +1,55 @@
 #include "pch.h"
 
-TypeMappingTrieNode * TypeMappingTrieNode::getSubNodeByNameIfExists(const string &name) {
-	auto iter = subNodesByName.find(name);
-	if (iter == subNodesByName.end()) return nullptr;
-	return iter->second.get();
-}
-
-TypeMapping * TypeMappingTrieNode::getTypeIfUnique() {
-	if (types.size() != 1) return nullptr;
-	return types.at(0).get();
-}
-
-bool TypeMappingTrieNode::isTypeAmbiguous() {
-	return types.size() >= 2;
+TypeMap::TypeMap(Config *config)
+	: config(config) {
+	trieNodes.emplace_back();
 }
 
-TypeMapping * TypeMappingTrieNode::getTypeMapping(const string &name, int64_t startIndex, const SourceLocation &sourceLocation) {
-	if (startIndex >= (int64_t)name.size()) {
-		if (isTypeAmbiguous()) throw ParseException(sourceLocation, sb() << "Ambiguous type: " << name << " (try using fully qualified name with namespace prefix)");
-		return getTypeIfUnique();
+int32_t TypeMap::getOrCreateSubNode(int32_t nodeId, const string &namePart) {
+	auto partIter = namePartIdsByName.find(namePart);
+	if (partIter == namePartIdsByName.end()) {
+		namePartStorage.push_back(namePart);
+		partIter = namePartIdsByName.emplace(namePartStorage.back(), (int32_t)namePartIdsByName.size()).first;
 	}
 
-	size_t partEndIndex = name.find(' ', startIndex);
-	if (partEndIndex == string::npos) partEndIndex = name.size();
-	TypeMappingTrieNode *subNode = getSubNodeByNameIfExists(name.substr(startIndex, partEndIndex - startIndex));
-	if (!subNode) {
-		return nullptr;
+	int32_t &subNodeId = trieNodeIdsByParentAndNamePart[getTrieNodeKey(nodeId, partIter->second)]; // Get or create entry.
+	if (subNodeId == 0) { // The root is never a sub-node.
+		subNodeId = (int32_t)trieNodes.size();
+		trieNodes.emplace_back();
 	}
-	return subNode->getTypeMapping(name, partEndIndex + 1, sourceLocation);
+	return subNodeId;
 }
 
-void TypeMappingTrieNode::addTypeMapping(vector<string> nameParts, int64_t namePartIndex, shared_ptr<TypeMapping> type) {
-	if (namePartIndex < 0 || namePartIndex > (int64_t)nameParts.size()) EXC(sb() << "Name part index out of range: " << namePartIndex << " for name '" << nameParts << "'");
-
+void TypeMap::addTypeMappingToTrie(const vector<string> &nameParts, size_t namePartIndex, int32_t nodeId, TypeMapping *type) {
 	if (namePartIndex == nameParts.size()) {
-		types.push_back(type);
-		//LOG_DEBUG(sb() << "Adding partially-qualified type mapping: " << partialName << " -> " << m->cppType << " (mappings with the same name: " << v.size() << ")");
+		trieNodes.at(nodeId).types.push_back(type);
 	}
 	else {
-		string typePart = nameParts[namePartIndex];
-		cppParseUtil->cppNamespaceParser.forEachPartialNamespaceSuffix(typePart, [&](const string &partialName) {
-			shared_ptr<TypeMappingTrieNode> &subNode = subNodesByName[partialName]; // Get or create sub-node entry.
-			if (!subNode) subNode = make_shared<TypeMappingTrieNode>();
-			subNode->addTypeMapping(nameParts, namePartIndex + 1, type);
+		cppParseUtil->cppNamespaceParser.forEachPartialNamespaceSuffix(nameParts.at(namePartIndex), [&](const string &partialName) {
+			addTypeMappingToTrie(nameParts, namePartIndex + 1, getOrCreateSubNode(nodeId, partialName), type);
 		});
 	}
 }
 
-//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TypeMap::ResolvedName TypeMap::resolveName(const string &name) {
+	ResolvedName result;
+	int32_t nodeId = 0;
+	size_t partStartIndex = 0;
+	while (true) {
+		size_t partEndIndex = name.find(' ', partStartIndex);
+		if (partEndIndex == string::npos) partEndIndex = name.size();
+		nodeId = getSubNodeIdIfExists(nodeId, string_view(name).substr(partStartIndex, partEndIndex - partStartIndex));
+		if (nodeId == invalidTrieNodeId) return result;
+		if (partEndIndex >= name.size()) break;
+		partStartIndex = partEndIndex + 1;
+	}
 
-TypeMap::TypeMap(Config *config)
-	: config(config) {
+	result.isAmbiguous = isNodeTypeAmbiguous(nodeId);
+	result.type = getNodeTypeIfUnique(nodeId);
+	return result;
 }
 
-void TypeMap::addTypeMapping(shared_ptr<TypeMapping> mapping) {
+void TypeMap::addTypeMapping(TypeMapping *mapping) {
 	LOG_DEBUG(sb() << "Adding type mapping: " << mapping->typeNames.cppType);
 	if (mapping->alignment != 0 && !isPowerOfTwo(mapping->alignment)) EXC(sb() << "Alignment must be a power-of-two (type: " << mapping->typeNames.cppType << ", alignment: " << mapping->alignment << ")");
 
@@ -79,7 +75,10 @@ void TypeMap::addTypeMapping(shared_ptr<TypeMapping> mapping) {
 
 	vector<string> typeParts;
 	boost::algorithm::split(typeParts, mapping->typeNames.cppType, boost::algorithm::is_space());
-	typeMappingsByPartiallyQualifiedSuffixes.addTypeMapping(typeParts, 0, mapping);
+	addTypeMappingToTrie(typeParts, 0, 0, mapping);
+
+	unique_lock<shared_mutex> _(resolvedNamesLock);
+	resolvedNamesByName.clear();
 
 	typeMappings.push_back(mapping);
 }
@@ -88,14 +87,50 @@ void TypeMap::checkAllTypesIdentified() {
 	if (!allTypesIdentified) EXC("Should not query type information before all input files have been scanned and type identified.");
 }
 
-TypeMappingTrieNode * TypeMap::getTypeMappingRootNodeAndCheckAllTypesAvailable() {
+int32_t TypeMap::getTypeMappingRootNodeIdAndCheckAllTypesAvailable() {
 	checkAllTypesIdentified();
-	return &typeMappingsByPartiallyQualifiedSuffixes;
+	return 0;
+}
+
+int32_t TypeMap::getSubNodeIdIfExists(int32_t nodeId, string_view namePart) {
+	auto partIter = namePartIdsByName.find(namePart);
+	if (partIter == namePartIdsByName.end()) return invalidTrieNodeId;
+	auto nodeIter = trieNodeIdsByParentAndNamePart.find(getTrieNodeKey(nodeId, partIter->second));
+	if (nodeIter == trieNodeIdsByParentAndNamePart.end()) return invalidTrieNodeId;
+	return nodeIter->second;
+}
+
+TypeMapping * TypeMap::getNodeTypeIfUnique(int32_t nodeId) {
+	const vector<TypeMapping *> &types = trieNodes.at(nodeId).types;
+	if (types.size() != 1) return nullptr;
+	return types.at(0);
+}
+
+bool TypeMap::isNodeTypeAmbiguous(int32_t nodeId) {
+	return trieNodes.at(nodeId).types.size() >= 2;
 }
 
 TypeMapping * TypeMap::getTypeMappingByPossiblyPartiallyQualifiedCppTypeIfExists(const string &name, const SourceLocation &sourceLocation) {
 	checkAllTypesIdentified();
-	return typeMappingsByPartiallyQualifiedSuffixes.getTypeMapping(name, 0, sourceLocation);
+
+	ResolvedName resolvedName;
+	bool found = false;
+	{
+		shared_lock<shared_mutex> _(resolvedNamesLock);
+		auto iter = resolvedNamesByName.find(name);
+		if (iter != resolvedNamesByName.end()) {
+			resolvedName = iter->second;
+			found = true;
+		}
+	}
+	if (!found) {
+		resolvedName = resolveName(name);
+		unique_lock<shared_mutex> _(resolvedNamesLock);
+		resolvedNamesByName[name] = resolvedName;
+	}
+
+	if (resolvedName.isAmbiguous) throw ParseException(sourceLocation, sb() << "Ambiguous type: " << name << " (try using fully qualified name with namespace prefix)");
+	return resolvedName.type;
 }
 
 TypeMapping * TypeMap::getTypeMappingByPossiblyPartiallyQualifiedCppTypeOrThrow(const string &name, const SourceLocation &sourceLocation) {
@@ -107,7 +142,7 @@ TypeMapping * TypeMap::getTypeMappingByPossiblyPartiallyQualifiedCppTypeOrThrow(
 
 void TypeMap::forEachTypeMapping(const function<void(TypeMapping *)> &c) {
 	for (const auto &mapping : typeMappings) {
-		c(mapping.get());
+		c(mapping);
 	}
 }
 
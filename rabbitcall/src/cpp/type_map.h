@@ -26,42 +26,58 @@ public:
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-// A trie structure for finding type mappings by multipart names, e.g. "signed int".
-// Includes all partial namespace variations, e.g. ns1::ns2::mytype has entries ns1::ns2::mytype, ns2::mytype, mytype.
-class TypeMappingTrieNode {
-	unordered_map<string, shared_ptr<TypeMappingTrieNode>> subNodesByName;
-	vector<shared_ptr<TypeMapping>> types;
-
-public:
-	TypeMappingTrieNode * getSubNodeByNameIfExists(const string &name);
-	TypeMapping * getTypeIfUnique();
-	bool isTypeAmbiguous();
-	TypeMapping * getTypeMapping(const string &name, int64_t startIndex, const SourceLocation &sourceLocation);
-
-	void addTypeMapping(vector<string> nameParts, int64_t namePartIndex, shared_ptr<TypeMapping> type);
-};
+// Contains all mappings between type names in different programming languages. The mappings themselves are owned by the project arena.
+// Type names can have multiple space-separated parts (e.g. "signed int"), and they are found using a trie that includes all partial
+// namespace variations of each part, e.g. ns1::ns2::mytype has entries ns1::ns2::mytype, ns2::mytype, mytype. The name parts are interned
+// and the trie is stored in a flat table keyed by the parent node and name part IDs. After all types have been identified, the type map
+// is read-only except for the cache of resolved names, so it can be used by multiple threads.
+class TypeMap {
 
-//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+	struct TrieNode {
+		vector<TypeMapping *> types;
+	};
 
-// Contains all mappings between type names in different programming languages.
-class TypeMap {
+	struct ResolvedName {
+		TypeMapping *type = nullptr; // Null if not found or ambiguous.
+		bool isAmbiguous = false;
+	};
 
 	Config *config = nullptr;
 	
-	unordered_map<string, shared_ptr<TypeMapping>> typeMappingsByFullyQualifiedCppType;
-	TypeMappingTrieNode typeMappingsByPartiallyQualifiedSuffixes;
-	vector<shared_ptr<TypeMapping>> typeMappings;
+	unordered_map<string, TypeMapping *> typeMappingsByFullyQualifiedCppType;
+	deque<string> namePartStorage;
+	unordered_map<string_view, int32_t> namePartIdsByName; // Points to namePartStorage.
+	vector<TrieNode> trieNodes; // The first one is the root.
+	unordered_map<uint64_t, int32_t> trieNodeIdsByParentAndNamePart;
+	vector<TypeMapping *> typeMappings;
+
+	shared_mutex resolvedNamesLock;
+	unordered_map<string, ResolvedName> resolvedNamesByName;
+
+	static uint64_t getTrieNodeKey(int32_t parentNodeId, int32_t namePartId) { return ((uint64_t)(uint32_t)parentNodeId << 32) | (uint32_t)namePartId; }
+	int32_t getOrCreateSubNode(int32_t nodeId, const string &namePart);
+	void addTypeMappingToTrie(const vector<string> &nameParts, size_t namePartIndex, int32_t nodeId, TypeMapping *type);
+	ResolvedName resolveName(const string &name);
 
 public:
+	static constexpr int32_t invalidTrieNodeId = -1;
+
 	bool allTypesIdentified = false; // True when all custom type names (classes etc.) are known, i.e. all input files have been scanned, which allows identifying type names in variable/function declarations.
 
 	explicit TypeMap(Config *config);
 	DISABLE_COPY_AND_MOVE(TypeMap);
 	~TypeMap() = default;
 
-	void addTypeMapping(shared_ptr<TypeMapping> mapping);
+	void addTypeMapping(TypeMapping *mapping);
 	void checkAllTypesIdentified();
-	TypeMappingTrieNode * getTypeMappingRootNodeAndCheckAllTypesAvailable();
+
+	// For finding the longest type name in a sequence of name parts one part at a time.
+	int32_t getTypeMappingRootNodeIdAndCheckAllTypesAvailable();
+	int32_t getSubNodeIdIfExists(int32_t nodeId, string_view namePart); // Returns invalidTrieNodeId if not found.
+	TypeMapping * getNodeTypeIfUnique(int32_t nodeId);
+	bool isNodeTypeAmbiguous(int32_t nodeId);
+
+	// The results are cached by the name, so repeated lookups of the same name are fast.
 	TypeMapping * getTypeMappingByPossiblyPartiallyQualifiedCppTypeIfExists(const string &name, const SourceLocation &sourceLocation);
 	TypeMapping * getTypeMappingByPossiblyPartiallyQualifiedCppTypeOrThrow(const string &name, const SourceLocation &sourceLocation);
 	void forEachTypeMapping(const function<void(TypeMapping *)> &c);
@@ -1,19 +1,22 @@
 #include "pch.h"
 
 void CppOutputGenerator::outputCallbackWrapper(CppFuncVar *callbackParam, CppFuncVar *enclosingFunction, CppClass *enclosingClassIfNotGlobal, StringBuilder &output, string *wrapperClassNameOut) {
-	string wrapperClassName = cppProject->reserveCppGlobalIdentifier(sb() << OUTPUT_CALLBACK "_" << (enclosingClassIfNotGlobal ? enclosingClassIfNotGlobal->typeNames.cppType : "global") << "_" << enclosingFunction->declarationName << "_" << callbackParam->declarationName);
+	string wrapperClassName = partition->getCallbackWrapperClassName(callbackParam, enclosingFunction, enclosingClassIfNotGlobal);
 	*wrapperClassNameOut = wrapperClassName;
 
 	CppFuncVar returnType = callbackParam->getFunctionReturnType();
 
 	output << OUTPUT_CALLBACK_WRAPPER "(" << wrapperClassName << ", ";
-	output << "typedef " << formatDeclaration(*callbackParam, "FunctionPtrType", Language::CPP, TypePresentation::TRANSFER_PARAMETER) << ", ";
-	output << formatDeclaration(returnType, "operator()", Language::CPP, TypePresentation::PUBLIC) << "(";
+	output << "typedef ";
+	formatDeclaration(output, *callbackParam, "FunctionPtrType", Language::CPP, TypePresentation::TRANSFER_PARAMETER);
+	output << ", ";
+	formatDeclaration(output, returnType, "operator()", Language::CPP, TypePresentation::PUBLIC);
+	output << "(";
 
 	{
 		StringJoiner joiner(&output, ",");
 		for (auto &param : callbackParam->functionParameters) {
-			joiner.append(formatDeclaration(*param, Language::CPP, TypePresentation::PUBLIC));
+			formatDeclaration(joiner.appendElement(), *param, Language::CPP, TypePresentation::PUBLIC);
 		}
 		joiner.finish();
 	}
@@ -22,7 +25,8 @@ void CppOutputGenerator::outputCallbackWrapper(CppFuncVar *callbackParam, CppFun
 	const char *returnTempVariableIfUsed = nullptr;
 	if (!returnType.isVoid()) {
 		returnTempVariableIfUsed = OUTPUT_RETURN_VALUE_TEMP;
-		output << formatDeclaration(returnType, OUTPUT_RETURN_VALUE_TEMP, Language::CPP, TypePresentation::TRANSFER_CALLBACK_RETURN_VALUE) << " = ";
+		formatDeclaration(output, returnType, OUTPUT_RETURN_VALUE_TEMP, Language::CPP, TypePresentation::TRANSFER_CALLBACK_RETURN_VALUE);
+		output << " = ";
 	}
 	output << "cb->callbackHandler(";
 	{
@@ -43,7 +47,9 @@ void CppOutputGenerator::outputCallbackWrapper(CppFuncVar *callbackParam, CppFun
 	if (returnType.type->isString) {
 		// Convert the temporary "const char *" string to an std::string object (or similar depending on string type) before deallocating the temporary string.
 		returnTempVariableIfUsed = OUTPUT_RETURN_VALUE_TEMP2;
-		output << " " << formatDeclaration(returnType, OUTPUT_RETURN_VALUE_TEMP2, Language::CPP, TypePresentation::PUBLIC) << "(" << OUTPUT_RETURN_VALUE_TEMP << ");";
+		output << " ";
+		formatDeclaration(output, returnType, OUTPUT_RETURN_VALUE_TEMP2, Language::CPP, TypePresentation::PUBLIC);
+		output << "(" << OUTPUT_RETURN_VALUE_TEMP << ");";
 
 		output << " " << OUTPUT_DEALLOCATE_TASKMEM << "((void *)" << OUTPUT_RETURN_VALUE_TEMP << ");";
 	}
@@ -63,7 +69,7 @@ void CppOutputGenerator::outputFunction(CppFuncVar *func, CppClass *enclosingCla
 
 	vector<string> wrapperClassNamesByParameterIndex;
 	for (int i = 0; i < (int)func->functionParameters.size(); i++) {
-		CppFuncVar *param = func->functionParameters.at(i).get();
+		CppFuncVar *param = func->functionParameters.at(i);
 
 		if (param->isLambdaFunction) {
 			// For each callback function, generate a functor class that keeps a reference count to the C# object and translates calls from C++ to C#.
@@ -90,8 +96,8 @@ void CppOutputGenerator::outputFunction(CppFuncVar *func, CppClass *enclosingCla
 
 		for (int i = 0; i < (int)func->functionParameters.size(); i++) {
 			string paramName = string(OUTPUT_PARAM_NAME_PREFIX) + to_string(i);
-			CppFuncVar *param = func->functionParameters.at(i).get();
-			joiner.append(formatDeclaration(*param, paramName, Language::CPP, TypePresentation::TRANSFER_PARAMETER));
+			CppFuncVar *param = func->functionParameters.at(i);
+			formatDeclaration(joiner.appendElement(), *param, paramName, Language::CPP, TypePresentation::TRANSFER_PARAMETER);
 		}
 
 		for (int i = 0; i < (int)wrapperClassNamesByParameterIndex.size(); i++) {
@@ -99,7 +105,7 @@ void CppOutputGenerator::outputFunction(CppFuncVar *func, CppClass *enclosingCla
 		}
 
 		if (!func->isVoid()) {
-			joiner.append(formatDeclaration(getFunctionReturnValuePtrType(func), Language::CPP, TypePresentation::TRANSFER_RETURN_VALUE));
+			formatDeclaration(joiner.appendElement(), getFunctionReturnValuePtrType(func), Language::CPP, TypePresentation::TRANSFER_RETURN_VALUE);
 		}
 
 		if (isExceptionCheckEnabled) {
@@ -148,7 +154,7 @@ void CppOutputGenerator::outputFunction(CppFuncVar *func, CppClass *enclosingCla
 			for (int i = 0; i < (int)func->functionParameters.size(); i++) {
 				string paramName = string(OUTPUT_PARAM_NAME_PREFIX) + to_string(i);
 
-				CppFuncVar *param = func->functionParameters.at(i).get();
+				CppFuncVar *param = func->functionParameters.at(i);
 				TypeMapping *paramType = param->type;
 				if (param->isLambdaFunction) {
 					// Wrap the callback function pointer in a functor that can be passed e.g. as a lambda function to the final C++ function. Create a C++ object that maintains a reference count and releases
@@ -215,8 +221,100 @@ void CppOutputGenerator::outputEnum(CppClass *clazz, StringBuilder &output) {
 	}
 }
 
+void CppOutputGenerator::outputTypeRegistration(TypeMapping *typeMapping, StringBuilder &output) {
+	string typeName = typeMapping->typeNames.cppType;
+	string sizeExpr = "0";
+	if (typeMapping->hasDefinedSize()) {
+		sizeExpr = sb() << "sizeof(" << typeName << ")";
+	}
+	output.appendIndent() << "rabbitCallInternal.typesByName[\"" << typeName << "\"] = new RabbitCallType(\"" << typeName << "\", " << sizeExpr << ");\n";
+}
+
+void CppOutputGenerator::outputEnumMappings(CppClass *clazz, StringBuilder &output) {
+	string enumVariable = partition->getEnumReflectionVariableName(clazz, false);
+	// Set the enum mappings in reverse order so that if multiple fields have the same value, the value will be mapped to the first one.
+	for (int64_t i = (int64_t)clazz->enumFields.size() - 1; i >= 0; i--) {
+		CppEnumField &field = clazz->enumFields.at(i);
+		string name = field.name;
+		output.appendIndent() << "RabbitCallInternalNamespace::" << enumVariable << ".setMapping((int64_t)" << clazz->typeNames.cppType << "::" << name << ", \"" << name << "\");\n";
+	}
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+void CppOutputGenerator::outputSourceHeaderIncludes(const set<string> &headers, StringBuilder &output) {
+	if (config->includeSourceHeadersInGeneratedCpp) {
+		for (const string &file : headers) {
+			output.appendIndent() << "#include \"" << getRelativePathForIncludeDirective(file) << "\"\n";
+		}
+	}
+}
+
+void CppOutputGenerator::generateSourceHeaderOutput(CppPartition::SourceHeaderElements *elements, StringBuilder &output) {
+	output.appendIndent() << "// " << getAutogeneratedFileComment() << '\n';
+	output.appendLine("");
+	output.appendLine(config->generatedCppFilePrologue);
+
+	set<string> headers;
+	for (CppClass *clazz : elements->classes) {
+		partition->addSourceHeaderDependenciesOfClass(clazz, &headers);
+	}
+	for (CppFuncVar *func : elements->globalFunctions) {
+		partition->addSourceHeaderDependenciesOfGlobalFunction(func, &headers);
+	}
+	outputSourceHeaderIncludes(headers, output);
+
+	output.appendLine("");
+	output.appendIndent() << "#include \"" << getRelativePathForIncludeDirective(generatedHeaderFile->file.toString()) << "\"\n";
+
+	// The enum reflection variables are defined in the partition's .cpp file.
+	output.appendLine("");
+	output.appendLine("namespace RabbitCallInternalNamespace {");
+	output.changeIndent(+1);
+	for (CppClass *clazz : elements->classes) {
+		if (clazz->classType == CppClassDeclarationType::ENUM) {
+			output.appendIndent() << "extern RabbitCallEnum " << partition->getEnumReflectionVariableName(clazz, false) << ";\n";
+		}
+	}
+	output.appendIndent() << "void " << elements->initFunctionName << "();\n";
+	output.changeIndent(-1);
+	output.appendLine("}");
+
+	output.appendLine("");
+	output.appendLine("using namespace RabbitCallInternalNamespace;");
+
+	output.appendLine("");
+	output.appendIndent() << "void RabbitCallInternalNamespace::" << elements->initFunctionName << "() {\n";
+	output.changeIndent(+1);
+	for (CppClass *clazz : elements->classes) {
+		outputTypeRegistration(clazz->typeMapping, output);
+	}
+	for (CppClass *clazz : elements->classes) {
+		if (clazz->classType == CppClassDeclarationType::ENUM) {
+			outputEnumMappings(clazz, output);
+		}
+	}
+	output.changeIndent(-1);
+	output.appendLine("}");
+
+	for (CppClass *clazz : elements->classes) {
+		if (clazz->classType == CppClassDeclarationType::ENUM) {
+			outputEnum(clazz, output);
+		}
+	}
+
+	output.appendLine("");
+	for (CppFuncVar *func : elements->globalFunctions) {
+		outputFunction(func, nullptr, output);
+	}
+
+	for (CppClass *clazz : elements->classes) {
+		outputClass(clazz, output);
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 void CppOutputGenerator::generateOutput(StringBuilder &output) {
 	StopWatch stopWatch = app->createStopWatchForPerformanceMeasurement();
 
@@ -225,15 +323,34 @@ void CppOutputGenerator::generateOutput(StringBuilder &output) {
 
 	typeMap = cppProject->getTypeMap();
 
+	if (!outputFile->sourceHeaderFile.empty()) {
+		generateSourceHeaderOutput(partition->getSourceHeaderElements(outputFile->sourceHeaderFile), output);
+		stopWatch.mark("output / generate .cpp");
+		return;
+	}
+
+	// The elements of source headers that have their own generated .cpp files are skipped (see Config::generateCppFilePerSourceHeader).
+	auto isInOwnFile = [&](const SourceLocation &location) {
+		return partition->isInSourceHeaderCppOutputFile(location.getFilename());
+	};
+
 	output.appendIndent() << "// " << getAutogeneratedFileComment() << '\n';
 	output.appendLine("");
 	output.appendLine(config->generatedCppFilePrologue);
 
-	if (config->includeSourceHeadersInGeneratedCpp) {
-		for (const string &file : partition->getSourceHeaderFilesUsed()) {
-			output.appendIndent() << "#include \"" << getRelativePathForIncludeDirective(file) << "\"\n";
+	// Include only the headers that declare the exported elements and the types in their signatures.
+	set<string> headers;
+	partition->forEachClass([&](CppClass *clazz) {
+		if (!isInOwnFile(clazz->sourceLocation)) {
+			partition->addSourceHeaderDependenciesOfClass(clazz, &headers);
 		}
-	}
+	});
+	partition->forEachGlobalFunction([&](CppFuncVar *func) {
+		if (!isInOwnFile(func->sourceLocation)) {
+			partition->addSourceHeaderDependenciesOfGlobalFunction(func, &headers);
+		}
+	});
+	outputSourceHeaderIncludes(headers, output);
 	
 	if (generatedHeaderFile) {
 		output.appendLine("");
@@ -330,6 +447,9 @@ void CppOutputGenerator::generateOutput(StringBuilder &output) {
 		partition->forEachEnum([&](CppClass* clazz) {
 			output.appendIndent() << "RabbitCallEnum " << partition->getEnumReflectionVariableName(clazz, false) << ";\n";
 		});
+		for (const auto &file : partition->getSourceHeaderCppOutputFiles()) {
+			output.appendIndent() << "void " << partition->getSourceHeaderElements(file->sourceHeaderFile)->initFunctionName << "();\n";
+		}
 	}
 	output.changeIndent(-1);
 	output.appendLine("}");
@@ -404,38 +524,40 @@ void CppOutputGenerator::generateOutput(StringBuilder &output) {
 	output.appendIndent() << "versionString += \"" << partition->getName() << "=" << config->version << "\";\n";
 	typeMap->forEachTypeMapping([&](TypeMapping *typeMapping) {
 		if ((typeMapping->partitionName.empty() && isMainPartition()) || typeMapping->partitionName == partition->getName()) {
-			string typeName = typeMapping->typeNames.cppType;
-			string sizeExpr = "0";
-			if (typeMapping->hasDefinedSize()) {
-				sizeExpr = sb() << "sizeof(" << typeName << ")";
+			if (!isInOwnFile(typeMapping->sourceLocation)) {
+				outputTypeRegistration(typeMapping, output);
 			}
-			output.appendIndent() << "rabbitCallInternal.typesByName[\"" << typeName << "\"] = new RabbitCallType(\"" << typeName << "\", " << sizeExpr << ");\n";
 		}
 	});
 	partition->forEachEnum([&](CppClass *clazz) {
-		string enumVariable = partition->getEnumReflectionVariableName(clazz, false);
-		// Set the enum mappings in reverse order so that if multiple fields have the same value, the value will be mapped to the first one.
-		for (int64_t i = (int64_t)clazz->enumFields.size() - 1; i >= 0; i--) {
-			CppEnumField &field = clazz->enumFields.at(i);
-			string name = field.name;
-			output.appendIndent() << "RabbitCallInternalNamespace::" << enumVariable << ".setMapping((int64_t)" << clazz->typeNames.cppType << "::" << name << ", \"" << name << "\");\n";
+		if (!isInOwnFile(clazz->sourceLocation)) {
+			outputEnumMappings(clazz, output);
 		}
 	});
+	for (const auto &file : partition->getSourceHeaderCppOutputFiles()) {
+		output.appendIndent() << partition->getSourceHeaderElements(file->sourceHeaderFile)->initFunctionName << "();\n";
+	}
 	output.changeIndent(-1);
 	output.appendLine("}");
 
 	partition->forEachEnum([&](CppClass *clazz) {
-		outputEnum(clazz, output);
+		if (!isInOwnFile(clazz->sourceLocation)) {
+			outputEnum(clazz, output);
+		}
 	});
 
 	output.appendLine("");
 	partition->forEachGlobalFunction([&](CppFuncVar *func) {
-		outputFunction(func, nullptr, output);
+		if (!isInOwnFile(func->sourceLocation)) {
+			outputFunction(func, nullptr, output);
+		}
 	});
 
-	partition->forEachClass([&](CppClass *clazz) {
-		outputClass(clazz, output);
-	});
+	outputClassesConcurrently([&](CppClass *clazz, StringBuilder &classOutput) {
+		if (!isInOwnFile(clazz->sourceLocation)) {
+			outputClass(clazz, classOutput);
+		}
+	}, output);
 
 	stopWatch.mark("output / generate .cpp");
 }
@@ -16,6 +16,16 @@ class CppOutputGenerator : public OutputFileGenerator {
 
 	void outputEnum(CppClass *clazz, StringBuilder &output);
 
+	// Outputs the lines of the partition/source header initialization function that register a type or the names of enum values.
+	void outputTypeRegistration(TypeMapping *typeMapping, StringBuilder &output);
+	void outputEnumMappings(CppClass *clazz, StringBuilder &output);
+
+	// Outputs #include directives for the given source headers if enabled in the configuration.
+	void outputSourceHeaderIncludes(const set<string> &headers, StringBuilder &output);
+
+	// Outputs the glue code of a single source header (see Config::generateCppFilePerSourceHeader).
+	void generateSourceHeaderOutput(CppPartition::SourceHeaderElements *elements, StringBuilder &output);
+
 public:
 	CppOutputGenerator() = default;
 	DISABLE_COPY_AND_MOVE(CppOutputGenerator);
@@ -52,11 +52,11 @@ void CsOutputGenerator::outputFunction(CppFuncVar *func, CppClass *enclosingClas
 	vector<int64_t> callbackIndicesByParameterIndex;
 	vector<string> delegateTypeNamesByParameterIndex; // Contains empty strings for those parameters that are not callback functions.
 	vector<string> delegateDeclarationLines;
-	for (const shared_ptr<CppFuncVar> &param : func->functionParameters) {
+	for (CppFuncVar *param : func->functionParameters) {
 		string delegateTypeName;
 		int64_t callbackIndex = -1;
 		if (param->isLambdaFunction) {
-			callbackParameters.push_back(param.get());
+			callbackParameters.push_back(param);
 
 			CppFuncVar returnType = param->getFunctionReturnType();
 
@@ -70,7 +70,7 @@ void CsOutputGenerator::outputFunction(CppFuncVar *func, CppClass *enclosingClas
 				StringBuilder delegateParameterList;
 				StringJoiner joiner(&delegateParameterList, ", ");
 				for (auto &cbParam : param->functionParameters) {
-					joiner.append(formatDeclaration(*cbParam, Language::CS, TypePresentation::PUBLIC));
+					formatDeclaration(joiner.appendElement(), *cbParam, Language::CS, TypePresentation::PUBLIC);
 				}
 				joiner.finish();
 				delegateDeclarationLines.push_back(sb() << "public delegate " << formatDeclaration(returnType, delegateTypeName, Language::CS, TypePresentation::PUBLIC) << "(" << delegateParameterList << ");");
@@ -79,30 +79,32 @@ void CsOutputGenerator::outputFunction(CppFuncVar *func, CppClass *enclosingClas
 			callbackIndex = callbacksOut.size();
 			callbacksOut.emplace_back();
 			Callback &callback = callbacksOut.back();
-			callback.callback = param.get();
+			callback.callback = param;
 			callback.publicDelegateTypeName = delegateTypeName;
 		}
 		delegateTypeNamesByParameterIndex.push_back(delegateTypeName);
 		callbackIndicesByParameterIndex.push_back(callbackIndex);
 	}
 
-	outputComment(func->comment.get(), output);
+	outputComment(func->comment, output);
 
 	{
 		output.appendIndent();
 
 		// Output the signature of the wrapper function that is called by application C# code.
 		{
-			output << "public " << (isNonStaticMember ? "" : "static ") << formatDeclaration(func->getFunctionReturnTypeAndName(), Language::CS, TypePresentation::PUBLIC) << "(";
+			output << "public " << (isNonStaticMember ? "" : "static ");
+			formatDeclaration(output, func->getFunctionReturnTypeAndName(), Language::CS, TypePresentation::PUBLIC);
+			output << "(";
 			StringJoiner joiner(&output, ", ");
 			for (int i = 0; i < (int)func->functionParameters.size(); i++) {
-				CppFuncVar *param = func->functionParameters.at(i).get();
+				CppFuncVar *param = func->functionParameters.at(i);
 				string delegateName = delegateTypeNamesByParameterIndex.at(i);
 				if (!delegateName.empty()) { // This parameter is a callback function
 					joiner.append(sb() << delegateName << " " << param->declarationName);
 				}
 				else {
-					joiner.append(formatDeclaration(*param, Language::CS, TypePresentation::PUBLIC));
+					formatDeclaration(joiner.appendElement(), *param, Language::CS, TypePresentation::PUBLIC);
 				}
 			}
 			joiner.finish();
@@ -112,7 +114,8 @@ void CsOutputGenerator::outputFunction(CppFuncVar *func, CppClass *enclosingClas
 		output << OUTPUT_INTERNAL_UTIL_CLASS "." OUTPUT_CHECK_INIT "();";
 		
 		if (!func->isVoid()) {
-			output << formatDeclaration(func->getFunctionReturnTypeAndName(), returnValuePtrName, Language::CS, TypePresentation::TRANSFER_RETURN_VALUE) << ";";
+			formatDeclaration(output, func->getFunctionReturnTypeAndName(), returnValuePtrName, Language::CS, TypePresentation::TRANSFER_RETURN_VALUE);
+			output << ";";
 		}
 
 		if (isExceptionCheckEnabled) {
@@ -129,7 +132,7 @@ void CsOutputGenerator::outputFunction(CppFuncVar *func, CppClass *enclosingClas
 			}
 
 			for (int64_t i = 0; i < (int64_t)func->functionParameters.size(); i++) {
-				CppFuncVar *param = func->functionParameters.at(i).get();
+				CppFuncVar *param = func->functionParameters.at(i);
 				int64_t callbackIndex = callbackIndicesByParameterIndex.at(i);
 				if (callbackIndex >= 0) {
 					// This is a callback parameter => send the pointer to the static delegate that receives the callback from C++.
@@ -190,13 +193,13 @@ void CsOutputGenerator::outputFunction(CppFuncVar *func, CppClass *enclosingClas
 				string paramName = string(OUTPUT_PARAM_NAME_PREFIX) + to_string(i);
 				
 				StringBuilder pb;
-				CppFuncVar *param = func->functionParameters.at(i).get();
+				CppFuncVar *param = func->functionParameters.at(i);
 				if (param->isLambdaFunction) {
 					// Send callback delegates as pointers.
 					pb << "IntPtr " << paramName;
 				}
 				else {
-					pb << formatDeclaration(*param, paramName, Language::CS, TypePresentation::TRANSFER_PARAMETER);
+					formatDeclaration(pb, *param, paramName, Language::CS, TypePresentation::TRANSFER_PARAMETER);
 				}
 				joiner.append(pb);
 			}
@@ -208,7 +211,7 @@ void CsOutputGenerator::outputFunction(CppFuncVar *func, CppClass *enclosingClas
 
 			// Retrieve the C++ function's return value using an out-parameter pointer, because using return values in P/Invoke is more complicated for complex types and can be slower.
 			if (!func->isVoid()) {
-				joiner.append(formatDeclaration(getFunctionReturnValuePtrType(func), Language::CS, TypePresentation::TRANSFER_RETURN_VALUE));
+				formatDeclaration(joiner.appendElement(), getFunctionReturnValuePtrType(func), Language::CS, TypePresentation::TRANSFER_RETURN_VALUE);
 			}
 
 			if (isExceptionCheckEnabled) {
@@ -240,7 +243,7 @@ void CsOutputGenerator::outputClass(CppClass *clazz, StringBuilder &output) {
 	string unqualifiedClassName = cppParseUtil->csNamespaceParser.getUnqualifiedNameFromQualifiedName(clazz->typeMapping->typeNames.csType);
 
 	if (clazz->classType == CppClassDeclarationType::CLASS || clazz->classType == CppClassDeclarationType::STRUCT) {
-		outputComment(clazz->comment.get(), output);
+		outputComment(clazz->comment, output);
 
 		if (clazz->typeMapping->isPassByValue) {
 			output.appendIndent() << "[StructLayout(LayoutKind.Explicit, Size = " << clazz->getLayoutOrThrow()->size << ")]\n";
@@ -271,10 +274,10 @@ void CsOutputGenerator::outputClass(CppClass *clazz, StringBuilder &output) {
 			for (auto &field : clazz->getLayoutOrThrow()->fields) {
 				int64_t arraySizeToUse = field.arraySize;
 				bool isArray = arraySizeToUse > 0;
-				string csTypeToUse = field.typeNames.csType;
+				string csTypeToUse = field.type->typeNames.csType;
 				bool useByteArrayInsteadOfUnsupportedStructArray = false;
 
-				outputComment(field.comment.get(), output);
+				outputComment(field.comment, output);
 
 				string fieldOffsetString = sb() << field.offset;
 				output.appendIndent();
@@ -314,11 +317,11 @@ void CsOutputGenerator::outputClass(CppClass *clazz, StringBuilder &output) {
 		output.appendLine("}");
 	}
 	else if (clazz->classType == CppClassDeclarationType::ENUM) {
-		outputComment(clazz->comment.get(), output);
+		outputComment(clazz->comment, output);
 		output.appendIndent() << "public enum " << unqualifiedClassName << " {\n";
 		output.changeIndent(+1);
 		for (const CppEnumField &field : clazz->enumFields) {
-			outputComment(field.comment.get(), output);
+			outputComment(field.comment, output);
 			output.appendIndent();
 			output << field.name;
 			if (!field.value.empty()) output << " = " << field.value;
@@ -358,7 +361,7 @@ void CsOutputGenerator::outputCallbackInternals(const string &className, vector<
 		StringBuilder delegateParameterList;
 		StringJoiner joiner(&delegateParameterList, ", ");
 		for (auto &cbParam : callback.callback->functionParameters) {
-			joiner.append(formatDeclaration(*cbParam, Language::CS, TypePresentation::TRANSFER_CALLBACK_PARAMETER));
+			formatDeclaration(joiner.appendElement(), *cbParam, Language::CS, TypePresentation::TRANSFER_CALLBACK_PARAMETER);
 		}
 		joiner.append("IntPtr " OUTPUT_CALLBACK_DELEGATE_INSTANCE_PARAM);
 		joiner.finish();
@@ -409,12 +412,7 @@ void CsOutputGenerator::outputCallbackInternals(const string &className, vector<
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-void CsOutputGenerator::generateOutput(StringBuilder &output) {
-	StopWatch stopWatch = app->createStopWatchForPerformanceMeasurement();
-
-	string apiClassName = config->getApiClassName();
-	string initMethodName = "init";
-
+void CsOutputGenerator::outputFileHeader(StringBuilder &output) {
 	output.appendIndent() << "// " << getAutogeneratedFileComment() << '\n';
 	output.appendLine("");
 	output.appendLine("// ReSharper disable All");
@@ -423,6 +421,60 @@ void CsOutputGenerator::generateOutput(StringBuilder &output) {
 	output.appendLine("using System.Runtime.InteropServices;");
 	output.appendLine("using System.Security;");
 	output.appendLine("using System.Text;");
+}
+
+void CsOutputGenerator::outputGlobalFunctions(const string &namespaceName, const vector<CppFuncVar *> &functions, StringBuilder &output) {
+	output.appendLine("");
+	NamespaceWriter funcNamespaceWriter(namespaceName);
+	funcNamespaceWriter.begin(output);
+
+	string globalClassName = config->csGlobalFunctionContainerClass;
+	output.appendIndent() << "public static unsafe partial class " << globalClassName << " {\n";
+	output.changeIndent(+1);
+
+	vector<Callback> callbacks;
+	int functionIndex = 0;
+	for (auto &func : functions) {
+		outputFunction(func, nullptr, functionIndex, output, callbacks);
+		functionIndex++;
+	}
+	outputCallbackInternals(globalClassName, callbacks, output);
+
+	output.changeIndent(-1);
+	output.appendLine("}");
+	funcNamespaceWriter.end(output);
+}
+
+void CsOutputGenerator::generatePartOutput(CppPartition::CsOutputPart *part, StringBuilder &output) {
+	outputFileHeader(output);
+
+	output.appendLine("");
+	NamespaceWriter namespaceWriter(config->csNamespace);
+	namespaceWriter.begin(output);
+
+	if (!part->globalFunctions.empty()) {
+		outputGlobalFunctions(part->globalFunctionNamespace, part->globalFunctions, output);
+	}
+	for (CppClass *clazz : part->classes) {
+		outputClass(clazz, output);
+	}
+
+	namespaceWriter.end(output);
+}
+
+void CsOutputGenerator::generateOutput(StringBuilder &output) {
+	StopWatch stopWatch = app->createStopWatchForPerformanceMeasurement();
+
+	if (!outputFile->csOutputPart.empty()) {
+		generatePartOutput(partition->getCsOutputPart(outputFile->csOutputPart), output);
+		stopWatch.mark("output / generate .cs");
+		return;
+	}
+
+	string apiClassName = config->getApiClassName();
+	string initMethodName = "init";
+
+	outputFileHeader(output);
 
 	output.appendLine("");
 	NamespaceWriter namespaceWriter(config->csNamespace);
@@ -569,39 +621,24 @@ void CsOutputGenerator::generateOutput(StringBuilder &output) {
 	output.changeIndent(-1);
 	output.appendLine("}");
 
-	map<string, vector<CppFuncVar *>> globalFunctionsByNamespace;
-	partition->forEachGlobalFunction([&](CppFuncVar *func) {
-		string ns = func->getNamespaceName();
-		vector<CppFuncVar *> &list = globalFunctionsByNamespace[ns];
-		list.push_back(func);
-	});
-
-	for (auto &entry : globalFunctionsByNamespace) {
-		output.appendLine("");
-		NamespaceWriter funcNamespaceWriter(entry.first);
-		funcNamespaceWriter.begin(output);
-
-		string globalClassName = config->csGlobalFunctionContainerClass;
-		output.appendIndent() << "public static unsafe partial class " << globalClassName << " {\n";
-		output.changeIndent(+1);
+	// If the output is split, the classes and global functions are in the part files.
+	if (!partition->hasCsOutputParts()) {
+		map<string, vector<CppFuncVar *>> globalFunctionsByNamespace;
+		partition->forEachGlobalFunction([&](CppFuncVar *func) {
+			string ns = func->getNamespaceName();
+			vector<CppFuncVar *> &list = globalFunctionsByNamespace[ns];
+			list.push_back(func);
+		});
 
-		vector<Callback> callbacks;
-		int functionIndex = 0;
-		for (auto &func : entry.second) {
-			outputFunction(func, nullptr, functionIndex, output, callbacks);
-			functionIndex++;
+		for (auto &entry : globalFunctionsByNamespace) {
+			outputGlobalFunctions(entry.first, entry.second, output);
 		}
-		outputCallbackInternals(globalClassName, callbacks, output);
 
-		output.changeIndent(-1);
-		output.appendLine("}");
-		funcNamespaceWriter.end(output);
+		outputClassesConcurrently([&](CppClass *clazz, StringBuilder &classOutput) {
+			outputClass(clazz, classOutput);
+		}, output);
 	}
 
-	partition->forEachClass([&](CppClass *clazz) {
-		outputClass(clazz, output);
-	});
-
 	namespaceWriter.end(output);
 
 	stopWatch.mark("output / generate .cs");
@@ -25,6 +25,14 @@ class CsOutputGenerator : public OutputFileGenerator {
 	// Outputs the internal handlers that receive callbacks from C++ and pass them to the application delegates.
 	void outputCallbackInternals(const string &className, vector<Callback> &callbacks, StringBuilder &output);
 
+	void outputFileHeader(StringBuilder &output);
+
+	// Outputs the global functions of a namespace in the global function container class.
+	void outputGlobalFunctions(const string &namespaceName, const vector<CppFuncVar *> &functions, StringBuilder &output);
+
+	// Outputs the classes and global functions of a part of the partition (see Config::csOutputSplitMode).
+	void generatePartOutput(CppPartition::CsOutputPart *part, StringBuilder &output);
+
 public:
 	CsOutputGenerator() = default;
 	DISABLE_COPY_AND_MOVE(CsOutputGenerator);
@@ -6,7 +6,7 @@ void GlslOutputGenerator::outputStructOrInterfaceBlock(CppClass *clazz, StringBu
 	CppExportParameters::GlslParameters glslParameters = clazz->exportParameters->glslParameters;
 
 	output.appendLine("");
-	outputComment(clazz->comment.get(), output);
+	outputComment(clazz->comment, output);
 	{
 		string storageType = glslParameters.storage;
 		if (storageType.empty()) storageType = "struct";
@@ -42,8 +42,8 @@ void GlslOutputGenerator::outputStructOrInterfaceBlock(CppClass *clazz, StringBu
 		if (field.pointerDepth > 0) throw ParseException(field.sourceLocation, "Pointer not allowed in a struct that is exported to GLSL");
 		if (field.elementSize % 4 != 0) throw ParseException(field.sourceLocation, "GLSL struct member size must be a multiple of 4 bytes");
 
-		string typeName = field.typeNames.glslType;
-		if (typeName.empty()) throw ParseException(field.sourceLocation, sb() << "GLSL data type not defined for C++ type (in configuration or in exported struct): " << field.typeNames.cppType);
+		string typeName = field.type->typeNames.glslType;
+		if (typeName.empty()) throw ParseException(field.sourceLocation, sb() << "GLSL data type not defined for C++ type (in configuration or in exported struct): " << field.type->typeNames.cppType);
 
 		bool isArray = field.arraySize > 0;
 		if (isArray && field.elementSize % 16 != 0) throw ParseException(field.sourceLocation, "Array not allowed in a struct that is exported to GLSL, unless the element size is divisible by 16 bytes (because GLSL would round the element size up to 16 bytes anyway)");
@@ -56,7 +56,7 @@ void GlslOutputGenerator::outputStructOrInterfaceBlock(CppClass *clazz, StringBu
 
 		if (offset != field.offset) throw ParseException(field.sourceLocation, sb() << "Field '" << field.name << "' offset would be different in GLSL (" << offset << ") than in C++ (" << field.offset << ")");
 
-		outputComment(field.comment.get(), output);
+		outputComment(field.comment, output);
 
 		output.appendIndent();
 		output << typeName;
@@ -91,13 +91,13 @@ void GlslOutputGenerator::outputEnum(CppClass *clazz, StringBuilder &output) {
 
 	output.appendLine("");
 
-	if (outputComment(clazz->comment.get(), output)) {
+	if (outputComment(clazz->comment, output)) {
 		output.appendLine("");
 	}
 
 	for (auto &field : clazz->enumFields) {
 		if (field.value.empty()) throw ParseException(field.sourceLocation, "Uninitialized enum fields not supported in GLSL");
-		outputComment(field.comment.get(), output);
+		outputComment(field.comment, output);
 		output.appendIndent() << "const int " << prefix << field.name << " = " << field.value << ";\n";
 	}
 }
@@ -6,7 +6,7 @@ void HlslOutputGenerator::outputStructOrConstantBuffer(CppClass *clazz, StringBu
 	CppExportParameters::HlslParameters hlslParameters = clazz->exportParameters->hlslParameters;
 
 	output.appendLine("");
-	outputComment(clazz->comment.get(), output);
+	outputComment(clazz->comment, output);
 	{
 		output.appendIndent();
 		output << (hlslParameters.isCBuffer ? "cbuffer" : "struct");
@@ -29,8 +29,8 @@ void HlslOutputGenerator::outputStructOrConstantBuffer(CppClass *clazz, StringBu
 		if (field.pointerDepth > 0) throw ParseException(field.sourceLocation, "Pointer not allowed in a struct that is exported to HLSL");
 		if (field.elementSize % 4 != 0) throw ParseException(field.sourceLocation, "HLSL struct member size must be a multiple of 4 bytes");
 
-		string typeName = field.typeNames.hlslType;
-		if (typeName.empty()) throw ParseException(field.sourceLocation, sb() << "HLSL data type not defined for C++ type (in configuration or in exported struct): " << field.typeNames.cppType);
+		string typeName = field.type->typeNames.hlslType;
+		if (typeName.empty()) throw ParseException(field.sourceLocation, sb() << "HLSL data type not defined for C++ type (in configuration or in exported struct): " << field.type->typeNames.cppType);
 
 		bool isArray = field.arraySize > 0;
 		if (isArray && field.elementSize % 16 != 0) throw ParseException(field.sourceLocation, "Array not allowed in a struct that is exported to HLSL, unless the element size is divisible by 16 bytes (because HLSL would round the element size up to 16 bytes anyway)");
@@ -44,7 +44,7 @@ void HlslOutputGenerator::outputStructOrConstantBuffer(CppClass *clazz, StringBu
 
 		if (offset != field.offset) throw ParseException(field.sourceLocation, sb() << "Field '" << field.name << "' offset would be different in HLSL (" << offset << ") than in C++ (" << field.offset << ")");
 
-		outputComment(field.comment.get(), output);
+		outputComment(field.comment, output);
 
 		output.appendIndent();
 		output << typeName;
@@ -73,13 +73,13 @@ void HlslOutputGenerator::outputEnum(CppClass *clazz, StringBuilder &output) {
 
 	output.appendLine("");
 
-	if (outputComment(clazz->comment.get(), output)) {
+	if (outputComment(clazz->comment, output)) {
 		output.appendLine("");
 	}
 
 	for (auto &field : clazz->enumFields) {
 		if (field.value.empty()) throw ParseException(field.sourceLocation, "Uninitialized enum fields not supported in HLSL");
-		outputComment(field.comment.get(), output);
+		outputComment(field.comment, output);
 		output.appendIndent() << "static const int " << prefix << field.name << " = " << field.value << ";\n";
 	}
 }
@@ -1,7 +1,7 @@
 #include "pch.h"
 
 
-void OutputFileGenerator::init(CppPartition *partition, CppPartition *mainPartition) {
+void OutputFileGenerator::init(CppPartition *partition, CppPartition *mainPartition, CppOutputFile *outputFileIfNotDefault) {
 	this->partition = partition;
 	this->mainPartition = mainPartition;
 
@@ -9,7 +9,7 @@ void OutputFileGenerator::init(CppPartition *partition, CppPartition *mainPartit
 	config = cppProject->getConfig();
 	cppLibraryFile = config->cppLibraryFile;
 
-	outputFile = partition->getOutputFileByTypeIfExists(getFileType()).get();
+	outputFile = outputFileIfNotDefault ? outputFileIfNotDefault : partition->getOutputFileByTypeIfExists(getFileType()).get();
 
 	if (outputFile && !outputFile->file.empty()) {
 		outputDir = outputFile->file.path().parent_path();
@@ -22,8 +22,12 @@ string OutputFileGenerator::getRelativePathForIncludeDirective(const string &fil
 	return result;
 }
 
+string OutputFileGenerator::getAutogeneratedFileComment(Config *config) {
+	return sb() << "This file was auto-generated by " << config->programName << " - do not modify manually.";
+}
+
 string OutputFileGenerator::getAutogeneratedFileComment() {
-	return sb() << "This file was auto-generated by " << cppProject->getConfig()->programName << " - do not modify manually.";
+	return getAutogeneratedFileComment(cppProject->getConfig());
 }
 
 CppFuncVar OutputFileGenerator::getFunctionReturnValuePtrType(const CppFuncVar *func) {
@@ -33,8 +37,9 @@ CppFuncVar OutputFileGenerator::getFunctionReturnValuePtrType(const CppFuncVar *
 	return type;
 }
 
-string OutputFileGenerator::formatDeclaration(const CppFuncVar &declaration, const string &displayName, Language language, TypePresentation presentation) {
-	StringBuilder b;
+void OutputFileGenerator::formatDeclaration(StringBuilder &b, const CppFuncVar &declaration, const string &displayName, Language language, TypePresentation presentation) {
+	size_t startLength = b.buffer.length();
+	auto doesEndWithPointerOrNothing = [&] { return b.buffer.length() <= startLength || b.buffer[b.buffer.length() - 1] == '*'; };
 
 	TypeMapping *typeMapping = declaration.type;
 	int pointerDepthToUse = declaration.pointerDepth;
@@ -68,7 +73,7 @@ string OutputFileGenerator::formatDeclaration(const CppFuncVar &declaration, con
 				b << " (*" << displayName << ")(";
 				StringJoiner joiner(&b, ",");
 				for (auto &param : declaration.functionParameters) {
-					joiner.append(formatDeclaration(*param, "", Language::CPP, TypePresentation::TRANSFER_CALLBACK_PARAMETER));
+					formatDeclaration(joiner.appendElement(), *param, "", Language::CPP, TypePresentation::TRANSFER_CALLBACK_PARAMETER);
 				}
 
 				if (presentation == TypePresentation::TRANSFER_PARAMETER) {
@@ -114,7 +119,7 @@ string OutputFileGenerator::formatDeclaration(const CppFuncVar &declaration, con
 	if (pointerDepthToUse > 0) {
 		// Add a space between variable type and the pointer asterisks, unless the type name ended with a pointer asterisk
 		// (in which case don't add an extra space between the asterisks).
-		if (b.buffer.length() > 0 && b.buffer[b.buffer.length() - 1] != '*') b << " ";
+		if (!doesEndWithPointerOrNothing()) b << " ";
 
 		for (int i = 0; i < pointerDepthToUse; i++) {
 			b << "*";
@@ -123,11 +128,19 @@ string OutputFileGenerator::formatDeclaration(const CppFuncVar &declaration, con
 
 	if (!variableNameAlreadyWritten && !displayName.empty()) {
 		// Add a space after the type if there are no pointer asterisks.
-		if (b.buffer.length() > 0 && b.buffer[b.buffer.length() - 1] != '*') b << " ";
+		if (!doesEndWithPointerOrNothing()) b << " ";
 
 		b << displayName;
 	}
+}
 
+void OutputFileGenerator::formatDeclaration(StringBuilder &b, const CppFuncVar &declaration, Language language, TypePresentation presentation) {
+	formatDeclaration(b, declaration, declaration.declarationName, language, presentation);
+}
+
+string OutputFileGenerator::formatDeclaration(const CppFuncVar &declaration, const string &displayName, Language language, TypePresentation presentation) {
+	StringBuilder b;
+	formatDeclaration(b, declaration, displayName, language, presentation);
 	return b;
 }
 
@@ -146,24 +159,56 @@ bool OutputFileGenerator::outputComment(CppComment *comment, StringBuilder &outp
 	return hasComments;
 }
 
-bool OutputFileGenerator::updateGeneratedUtf8FileIfModified(const Path &path, const void *data, int64_t length, bool addByteOrderMark, bool shouldUseCrLfLineBreaks, bool dryRun) {
+void OutputFileGenerator::outputClassesConcurrently(const function<void(CppClass *, StringBuilder &)> &c, StringBuilder &output) {
+	vector<CppClass *> classes;
+	partition->forEachClass([&](CppClass *clazz) {
+		classes.push_back(clazz);
+	});
+
+	vector<StringBuilder> classOutputs(classes.size());
+	vector<exception_ptr> exceptions(classes.size());
+	ThreadPool::TaskSet tasks(app->threadPool.get());
+	for (size_t i = 0; i < classes.size(); i++) {
+		classOutputs[i].lineIndent = output.lineIndent;
+		tasks.addTask([&, i]() {
+			try {
+				c(classes[i], classOutputs[i]);
+			}
+			catch (...) {
+				exceptions[i] = current_exception();
+			}
+		});
+	}
+	tasks.waitUntilEmpty();
+
+	for (size_t i = 0; i < classes.size(); i++) {
+		if (exceptions[i]) rethrow_exception(exceptions[i]);
+		output.append(move(classOutputs[i]));
+	}
+}
+
+bool OutputFileGenerator::updateGeneratedUtf8FileIfModified(const Path &path, const ChunkedOutput &output, bool dryRun) {
 	StopWatch stopWatch = app->createStopWatchForPerformanceMeasurement();
-	ByteBuffer newData;
-	if (addByteOrderMark) {
-		newData.put<uint8_t>(0xEF);
-		newData.put<uint8_t>(0xBB);
-		newData.put<uint8_t>(0xBF);
+	OutputManifest *manifest = app->outputManifest.get();
+	Hash128 contentHash;
+	if (manifest) {
+		contentHash = output.calculateHash();
+		bool isUnchanged = manifest->isFileUnchanged(path, output.getSize(), contentHash);
+		stopWatch.mark("output / update file / check manifest");
+
+		if (isUnchanged) {
+			LOG_DEBUG(sb() << "File up-to-date according to manifest: " << path);
+			return false;
+		}
 	}
-	convertLineBreaks(&newData, data, length, shouldUseCrLfLineBreaks);
-	stopWatch.mark("output / update file / convert line breaks");
 
 	if (exists(path.path())) {
-		ByteBuffer oldData;
-		loadBinaryFile(&oldData, path);
-		stopWatch.mark("output / update file / load old file");
+		bool isSame = output.isSameAsFileContent(path);
+		stopWatch.mark("output / update file / compare to old file");
 
-		if (oldData.getPosition() == newData.getPosition() && memcmp(oldData.getBuffer(), newData.getBuffer(), oldData.getPosition()) == 0) {
+		if (isSame) {
 			LOG_DEBUG(sb() << "File up-to-date: " << path);
+			if (manifest && !dryRun) manifest->updateFile(path, contentHash);
 			return false;
 		}
 	}
@@ -172,7 +217,8 @@ bool OutputFileGenerator::updateGeneratedUtf8FileIfModified(const Path &path, co
 		LOG_ERROR(sb() << "Would update auto-generated file if dry-run mode was not enabled: " << path);
 	}
 	else {
-		saveBinaryFile(path, newData.getBuffer(), newData.getPosition());
+		output.saveToFile(path);
+		if (manifest) manifest->updateFile(path, contentHash);
 		stopWatch.mark("output / update file / save");
 		LOG_INFO(sb() << "Saved auto-generated file: " << path);
 	}
@@ -66,21 +66,27 @@ public:
 	CppPartition * getMainPartition() { return mainPartition; }
 	bool isMainPartition() { return partition == mainPartition; }
 
-	void init(CppPartition *partition, CppPartition *mainPartition);
+	void init(CppPartition *partition, CppPartition *mainPartition, CppOutputFile *outputFileIfNotDefault = nullptr);
 	CppOutputFile * getOutputFile() { return outputFile; }
 
 	string getRelativePathForIncludeDirective(const string &file);
 
+	static string getAutogeneratedFileComment(Config *config);
 	string getAutogeneratedFileComment();
 	CppFuncVar getFunctionReturnValuePtrType(const CppFuncVar *func);
 
-	// Formats a type for either C++ or C# glue code.
+	// Formats a type for either C++ or C# glue code. The versions taking a StringBuilder append the result to it.
+	void formatDeclaration(StringBuilder &b, const CppFuncVar &declaration, const string &displayName, Language language, TypePresentation presentation);
+	void formatDeclaration(StringBuilder &b, const CppFuncVar &declaration, Language language, TypePresentation presentation);
 	string formatDeclaration(const CppFuncVar &declaration, const string &displayName, Language language, TypePresentation presentation);
 	string formatDeclaration(const CppFuncVar &declaration, Language language, TypePresentation presentation);
 
 	bool outputComment(CppComment *comment, StringBuilder &output);
 
-	bool updateGeneratedUtf8FileIfModified(const Path &path, const void *data, int64_t length, bool addByteOrderMark, bool shouldUseCrLfLineBreaks, bool dryRun);
+	// Generates the output of each class of the partition concurrently and appends the results to the output in class order.
+	void outputClassesConcurrently(const function<void(CppClass *, StringBuilder &)> &c, StringBuilder &output);
+
+	bool updateGeneratedUtf8FileIfModified(const Path &path, const ChunkedOutput &output, bool dryRun);
 
 	virtual string getFileType() = 0;
 	virtual void generateOutput(StringBuilder &output) = 0;
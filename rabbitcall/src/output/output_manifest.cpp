@@ -0,0 +1,182 @@
+#include "pch.h"
+
+
+static const char outputManifestFileMagic[] = "RCOM";
+static const uint64_t outputManifestFormatVersion = 2;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+OutputManifest::OutputManifest(const Path &path)
+	: path(path) {
+}
+
+bool OutputManifest::tryGetFileSizeAndLastModified(const Path &file, int64_t *fileSize, int64_t *lastModified) {
+	error_code errorCode;
+	uintmax_t size = filesystem::file_size(file.path(), errorCode);
+	if (errorCode) return false;
+	filesystem::file_time_type time = filesystem::last_write_time(file.path(), errorCode);
+	if (errorCode) return false;
+	*fileSize = (int64_t)size;
+	*lastModified = (int64_t)time.time_since_epoch().count();
+	return true;
+}
+
+void OutputManifest::load() {
+	StopWatch stopWatch = app->createStopWatchForPerformanceMeasurement();
+	lock_guard<mutex> lockGuard(lock);
+	entriesByPath.clear();
+	partitionFingerprintsByName.clear();
+	modified = false;
+
+	if (path.empty() || !exists(path.path())) {
+		LOG_DEBUG(sb() << "Output manifest does not exist: " << path);
+		return;
+	}
+
+	try {
+		ByteBuffer b;
+		loadBinaryFile(&b, path);
+		b.compact();
+		b.setPosition(0);
+
+		char magic[sizeof(outputManifestFileMagic) - 1];
+		b.getBytes(magic, sizeof(magic));
+		if (memcmp(magic, outputManifestFileMagic, sizeof(magic)) != 0) EXC("Not an output manifest file");
+		if (b.getVlq() != outputManifestFormatVersion) {
+			LOG_DEBUG(sb() << "Output manifest was created with a different version, ignoring it: " << path);
+			return;
+		}
+
+		uint64_t numEntries = b.getVlq();
+		for (uint64_t i = 0; i < numEntries; i++) {
+			string filePath = b.getString();
+			Entry entry;
+			entry.fileSize = b.get<int64_t>();
+			entry.lastModified = b.get<int64_t>();
+			entry.contentHash.low = b.get<uint64_t>();
+			entry.contentHash.high = b.get<uint64_t>();
+			entriesByPath[filePath] = entry;
+		}
+
+		uint64_t numPartitions = b.getVlq();
+		for (uint64_t i = 0; i < numPartitions; i++) {
+			string partitionName = b.getString();
+			Hash128 &fingerprint = partitionFingerprintsByName[partitionName];
+			fingerprint.low = b.get<uint64_t>();
+			fingerprint.high = b.get<uint64_t>();
+		}
+	}
+	catch (exception &e) {
+		LOG_INFO(sb() << "Ignoring invalid output manifest file (" << e.what() << "): " << path);
+		entriesByPath.clear();
+		partitionFingerprintsByName.clear();
+	}
+
+	stopWatch.mark("output manifest / load");
+}
+
+void OutputManifest::saveIfModified() {
+	lock_guard<mutex> lockGuard(lock);
+	if (!modified || path.empty()) return;
+
+	ByteBuffer b;
+	b.putBytes(outputManifestFileMagic, sizeof(outputManifestFileMagic) - 1);
+	b.putVlq(outputManifestFormatVersion);
+	b.putVlq(entriesByPath.size());
+	for (auto &entry : entriesByPath) {
+		b.putString(entry.first);
+		b.put<int64_t>(entry.second.fileSize);
+		b.put<int64_t>(entry.second.lastModified);
+		b.put<uint64_t>(entry.second.contentHash.low);
+		b.put<uint64_t>(entry.second.contentHash.high);
+	}
+	b.putVlq(partitionFingerprintsByName.size());
+	for (auto &entry : partitionFingerprintsByName) {
+		b.putString(entry.first);
+		b.put<uint64_t>(entry.second.low);
+		b.put<uint64_t>(entry.second.high);
+	}
+
+	saveBinaryFileViaTemporaryFile(path, b.getBuffer(), b.getPosition());
+	modified = false;
+	LOG_DEBUG(sb() << "Saved output manifest: " << path);
+}
+
+bool OutputManifest::isFileUnchanged(const Path &file, int64_t contentSize, const Hash128 &contentHash) {
+	int64_t fileSize, lastModified;
+	if (!tryGetFileSizeAndLastModified(file, &fileSize, &lastModified)) return false;
+
+	lock_guard<mutex> lockGuard(lock);
+	auto iter = entriesByPath.find(file.toString());
+	if (iter == entriesByPath.end()) return false;
+	Entry &entry = iter->second;
+	if (entry.fileSize != contentSize || entry.contentHash != contentHash) return false;
+	if (entry.fileSize != fileSize || entry.lastModified != lastModified) return false; // Modified by someone else.
+	entry.usedInCurrentRound = true;
+	return true;
+}
+
+void OutputManifest::updateFile(const Path &file, const Hash128 &contentHash) {
+	Entry entry;
+	if (!tryGetFileSizeAndLastModified(file, &entry.fileSize, &entry.lastModified)) EXC(sb() << "Cannot read file size and time: " << file);
+	entry.contentHash = contentHash;
+	entry.usedInCurrentRound = true;
+
+	lock_guard<mutex> lockGuard(lock);
+	Entry &oldEntry = entriesByPath[file.toString()];
+	if (oldEntry.fileSize != entry.fileSize || oldEntry.lastModified != entry.lastModified || oldEntry.contentHash != entry.contentHash) {
+		modified = true;
+	}
+	oldEntry = entry;
+}
+
+bool OutputManifest::isPartitionUnchanged(const string &partitionName, const Hash128 &fingerprint, const vector<Path> &outputFiles) {
+	lock_guard<mutex> lockGuard(lock);
+	auto fingerprintIter = partitionFingerprintsByName.find(partitionName);
+	if (fingerprintIter == partitionFingerprintsByName.end() || fingerprintIter->second != fingerprint) return false;
+
+	vector<Entry *> entries;
+	for (const Path &file : outputFiles) {
+		auto iter = entriesByPath.find(file.toString());
+		if (iter == entriesByPath.end()) return false;
+		int64_t fileSize, lastModified;
+		if (!tryGetFileSizeAndLastModified(file, &fileSize, &lastModified)) return false;
+		if (iter->second.fileSize != fileSize || iter->second.lastModified != lastModified) return false;
+		entries.push_back(&iter->second);
+	}
+
+	for (Entry *entry : entries) {
+		entry->usedInCurrentRound = true;
+	}
+	return true;
+}
+
+void OutputManifest::setPartitionFingerprints(const map<string, Hash128> &fingerprints) {
+	lock_guard<mutex> lockGuard(lock);
+	if (partitionFingerprintsByName != fingerprints) {
+		partitionFingerprintsByName = fingerprints;
+		modified = true;
+	}
+}
+
+void OutputManifest::startRound() {
+	lock_guard<mutex> lockGuard(lock);
+	for (auto &entry : entriesByPath) {
+		entry.second.usedInCurrentRound = false;
+	}
+}
+
+void OutputManifest::removeEntriesNotUsedInCurrentRound() {
+	lock_guard<mutex> lockGuard(lock);
+	for (auto iter = entriesByPath.begin(); iter != entriesByPath.end();) {
+		if (!iter->second.usedInCurrentRound) {
+			iter = entriesByPath.erase(iter);
+			modified = true;
+		}
+		else {
+			iter->second.usedInCurrentRound = false;
+			++iter;
+		}
+	}
+}
+
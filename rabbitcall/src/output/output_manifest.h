@@ -0,0 +1,46 @@
+#pragma once
+
+// Remembers the size, last-modified time and content hash of each generated file, so that an unchanged output can be detected
+// without reading the old file: if the new content has the same size and hash as when the file was written, and the file on disk
+// still has the same size and last-modified time, the file is up-to-date. Entries may be queried/updated concurrently.
+// If the path is empty, the manifest is only kept in memory (in watch mode).
+class OutputManifest {
+
+	struct Entry {
+		int64_t fileSize = 0;
+		int64_t lastModified = 0;
+		Hash128 contentHash;
+		bool usedInCurrentRound = false;
+	};
+
+	Path path;
+	mutex lock;
+	map<string, Entry> entriesByPath;
+	map<string, Hash128> partitionFingerprintsByName;
+	bool modified = false;
+
+	static bool tryGetFileSizeAndLastModified(const Path &file, int64_t *fileSize, int64_t *lastModified);
+
+public:
+	explicit OutputManifest(const Path &path);
+	DISABLE_COPY_AND_MOVE(OutputManifest);
+
+	void load();
+	void saveIfModified();
+
+	bool isFileUnchanged(const Path &file, int64_t contentSize, const Hash128 &contentHash);
+	// Updates the entry after the file has been written or found to be up-to-date.
+	void updateFile(const Path &file, const Hash128 &contentHash);
+
+	// Returns true if the partition's fingerprint is the same as when its files were generated, and the files have not been modified since.
+	bool isPartitionUnchanged(const string &partitionName, const Hash128 &fingerprint, const vector<Path> &outputFiles);
+	// Replaces the fingerprints of all partitions (none if the output files may not match them, e.g. after errors).
+	void setPartitionFingerprints(const map<string, Hash128> &fingerprints);
+
+	// Clears the flags that mark the entries used, in case the previous round ended without removeEntriesNotUsedInCurrentRound() (e.g. in dry-run mode).
+	void startRound();
+	// Removes entries for files that were not generated in the current round.
+	void removeEntriesNotUsedInCurrentRound();
+};
+
+
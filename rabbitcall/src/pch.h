@@ -13,6 +13,7 @@
 
 #include <cstdio>
 #include <string>
+#include <string_view>
 #include <iostream>
 #include <sstream>
 #include <fstream>
@@ -22,12 +23,15 @@
 #include <map>
 #include <unordered_map>
 #include <mutex>
+#include <shared_mutex>
 #include <condition_variable>
 #include <deque>
+#include <queue>
 #include <limits>
 #include <functional>
 #include <filesystem>
 #include <thread>
+#include <atomic>
 
 #include <boost/algorithm/string.hpp>
 
@@ -41,7 +45,6 @@ using namespace std;
 static const int applicationErrorReturnCode = 1;
 
 #include "util/util.h"
-#include "platform_specific.h"
 #include "util/log.h"
 #include "util/byte_buffer.h"
 #include "util/string_builder.h"
@@ -50,19 +53,27 @@ static const int applicationErrorReturnCode = 1;
 #include "util/line_numbers.h"
 #include "util/error_list.h"
 #include "util/thread_pool.h"
+#include "util/hash.h"
+#include "util/simd.h"
+#include "util/arena.h"
 #include "util/file_util.h"
+#include "util/chunked_output.h"
+#include "platform_specific.h"
 #include "config.h"
 #include "cpp/type_map.h"
 #include "cpp/cpp_file.h"
 #include "cpp/cpp_source_directory.h"
 #include "cpp/cpp_parse_util.h"
 #include "cpp/cpp_tokenizer.h"
+#include "cpp/cpp_tokenizer_benchmark.h"
 #include "cpp/cpp_items.h"
 #include "cpp/cpp_function_and_variable_parser.h"
 #include "cpp/cpp_file_parser.h"
+#include "cpp/cpp_parse_cache.h"
 #include "cpp/cpp_partition.h"
 #include "cpp/cpp_project.h"
 #include "output/output_file_generator.h"
+#include "output/output_manifest.h"
 #include "output/header_output_generator.h"
 #include "output/cpp_output_generator.h"
 #include "output/cs_output_generator.h"
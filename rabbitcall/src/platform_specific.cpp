@@ -3,6 +3,15 @@
 #if defined (_MSC_VER)
 #include <SDKDDKVer.h>
 #include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#if defined (__linux__)
+#include <sys/inotify.h>
+#include <poll.h>
+#endif
 #endif
 
 void setProcessPriorityToLow() {
@@ -42,3 +51,244 @@ FILE * openFileOrThrow(const filesystem::path &path, const string &mode, int64_t
 	return file;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined (_MSC_VER)
+
+struct FileChangeWatcher::PlatformState {
+	vector<HANDLE> handles;
+};
+
+FileChangeWatcher::FileChangeWatcher(const vector<Path> &dirs, const function<bool(const string &path, bool isDirectory)> &isRelevantChange)
+	: dirs(dirs), isRelevantChange(isRelevantChange), state(make_unique<PlatformState>()) {
+
+	for (const Path &dir : dirs) {
+		HANDLE handle = FindFirstChangeNotificationW(dir.path().wstring().c_str(), TRUE, FILE_NOTIFY_CHANGE_FILE_NAME | FILE_NOTIFY_CHANGE_DIR_NAME | FILE_NOTIFY_CHANGE_SIZE | FILE_NOTIFY_CHANGE_LAST_WRITE);
+		if (handle == INVALID_HANDLE_VALUE) EXC(sb() << "Could not watch directory for changes: " << dir);
+		state->handles.push_back(handle);
+	}
+}
+
+FileChangeWatcher::~FileChangeWatcher() {
+	for (HANDLE handle : state->handles) {
+		FindCloseChangeNotification(handle);
+	}
+}
+
+bool FileChangeWatcher::waitForChangeEvents(int timeoutMilliseconds) {
+	if (state->handles.empty()) {
+		this_thread::sleep_for(chrono::milliseconds(timeoutMilliseconds < 0 ? 1000 : timeoutMilliseconds));
+		return false;
+	}
+
+	// The notifications don't tell which files have changed, so every change is considered relevant
+	// (if the generated files are written under a watched directory, this will cause one extra round that won't change anything).
+	DWORD result = WaitForMultipleObjects((DWORD)state->handles.size(), state->handles.data(), FALSE, timeoutMilliseconds < 0 ? INFINITE : (DWORD)timeoutMilliseconds);
+	if (result >= WAIT_OBJECT_0 && result < WAIT_OBJECT_0 + state->handles.size()) {
+		FindNextChangeNotification(state->handles.at(result - WAIT_OBJECT_0));
+		return true;
+	}
+	return false;
+}
+
+#elif defined (__linux__)
+
+struct FileChangeWatcher::PlatformState {
+	int fd = -1;
+	unordered_map<int, string> dirsByWatchDescriptor;
+
+	void addWatchesRecursively(const string &dir) {
+		int wd = inotify_add_watch(fd, dir.c_str(), IN_CREATE | IN_DELETE | IN_MODIFY | IN_CLOSE_WRITE | IN_MOVED_FROM | IN_MOVED_TO);
+		if (wd < 0) EXC(sb() << "Could not watch directory for changes: " << dir << " (" << strerror(errno) << ")");
+		dirsByWatchDescriptor[wd] = dir;
+
+		error_code errorCode;
+		for (const filesystem::directory_entry &entry : filesystem::directory_iterator(Path(dir).path(), errorCode)) {
+			if (entry.is_directory(errorCode) && !entry.is_symlink(errorCode)) {
+				addWatchesRecursively(entry.path().u8string());
+			}
+		}
+	}
+};
+
+FileChangeWatcher::FileChangeWatcher(const vector<Path> &dirs, const function<bool(const string &path, bool isDirectory)> &isRelevantChange)
+	: dirs(dirs), isRelevantChange(isRelevantChange), state(make_unique<PlatformState>()) {
+
+	state->fd = inotify_init1(IN_CLOEXEC);
+	if (state->fd < 0) EXC(sb() << "Could not initialize inotify: " << strerror(errno));
+
+	for (const Path &dir : dirs) {
+		state->addWatchesRecursively(dir.path().u8string());
+	}
+}
+
+FileChangeWatcher::~FileChangeWatcher() {
+	if (state->fd >= 0) {
+		close(state->fd);
+	}
+}
+
+bool FileChangeWatcher::waitForChangeEvents(int timeoutMilliseconds) {
+	pollfd p = {};
+	p.fd = state->fd;
+	p.events = POLLIN;
+	int numReady = poll(&p, 1, timeoutMilliseconds);
+	if (numReady <= 0) return false;
+
+	alignas(inotify_event) char buffer[65536];
+	ssize_t length = read(state->fd, buffer, sizeof(buffer));
+	if (length <= 0) return false;
+
+	bool changed = false;
+	for (ssize_t pos = 0; pos < length;) {
+		const inotify_event *event = (const inotify_event *)(buffer + pos);
+		pos += sizeof(inotify_event) + event->len;
+
+		if (event->mask & IN_Q_OVERFLOW) {
+			// Some events were lost => assume that something relevant has changed.
+			changed = true;
+			continue;
+		}
+		if (event->mask & IN_IGNORED) {
+			state->dirsByWatchDescriptor.erase(event->wd);
+			continue;
+		}
+
+		auto iter = state->dirsByWatchDescriptor.find(event->wd);
+		if (iter == state->dirsByWatchDescriptor.end() || event->len == 0) continue;
+		string path = iter->second + "/" + event->name;
+		bool isDirectory = (event->mask & IN_ISDIR) != 0;
+
+		if (isDirectory && (event->mask & (IN_CREATE | IN_MOVED_TO))) {
+			error_code errorCode;
+			if (filesystem::is_directory(Path(path).path(), errorCode)) {
+				state->addWatchesRecursively(path);
+			}
+		}
+
+		if (isRelevantChange(path, isDirectory)) {
+			LOG_DEBUG(sb() << "File changed: " << path);
+			changed = true;
+		}
+	}
+	return changed;
+}
+
+#else
+
+struct FileChangeWatcher::PlatformState {
+};
+
+FileChangeWatcher::FileChangeWatcher(const vector<Path> &dirs, const function<bool(const string &path, bool isDirectory)> &isRelevantChange)
+	: dirs(dirs), isRelevantChange(isRelevantChange), state(make_unique<PlatformState>()) {
+	fileSizesAndTimesByPath = scanFileSizesAndTimes();
+}
+
+FileChangeWatcher::~FileChangeWatcher() {
+}
+
+bool FileChangeWatcher::waitForChangeEvents(int timeoutMilliseconds) {
+	// No change notification API available => poll by scanning the directories.
+	int pollIntervalMilliseconds = 1000;
+	this_thread::sleep_for(chrono::milliseconds(timeoutMilliseconds < 0 ? pollIntervalMilliseconds : min(timeoutMilliseconds, pollIntervalMilliseconds)));
+	map<string, pair<int64_t, int64_t>> newFileSizesAndTimesByPath = scanFileSizesAndTimes();
+	bool changed = newFileSizesAndTimesByPath != fileSizesAndTimesByPath;
+	fileSizesAndTimesByPath = newFileSizesAndTimesByPath;
+	return changed;
+}
+
+#endif
+
+map<string, pair<int64_t, int64_t>> FileChangeWatcher::scanFileSizesAndTimes() {
+	map<string, pair<int64_t, int64_t>> result;
+	for (const Path &dir : dirs) {
+		error_code errorCode;
+		for (const filesystem::directory_entry &entry : filesystem::recursive_directory_iterator(dir.path(), errorCode)) {
+			if (entry.is_regular_file(errorCode)) {
+				string path = entry.path().u8string();
+				if (isRelevantChange(path, false)) {
+					result[path] = make_pair((int64_t)entry.file_size(errorCode), (int64_t)entry.last_write_time(errorCode).time_since_epoch().count());
+				}
+			}
+		}
+	}
+	return result;
+}
+
+void FileChangeWatcher::waitForChanges(int quietPeriodMilliseconds) {
+	bool changed = false;
+	while (true) {
+		if (waitForChangeEvents(changed ? quietPeriodMilliseconds : -1)) {
+			changed = true;
+		}
+		else if (changed) {
+			break;
+		}
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined (_MSC_VER)
+
+MappedFile::MappedFile(const Path &path) {
+	HANDLE file = CreateFileW(path.path().wstring().c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE | FILE_SHARE_DELETE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL | FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+	if (file == INVALID_HANDLE_VALUE) EXC(sb() << "Error opening file: " << path);
+
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(file, &fileSize)) {
+		CloseHandle(file);
+		EXC(sb() << "Error reading file size: " << path);
+	}
+	size = (int64_t)fileSize.QuadPart;
+
+	// An empty file cannot be mapped.
+	if (size > 0) {
+		HANDLE mapping = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+		if (mapping) {
+			data = (const uint8_t *)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0);
+			CloseHandle(mapping); // The view keeps the mapping alive.
+		}
+	}
+	CloseHandle(file);
+
+	if (size > 0 && !data) EXC(sb() << "Error mapping file to memory: " << path);
+}
+
+MappedFile::~MappedFile() {
+	if (data) UnmapViewOfFile(data);
+}
+
+#else
+
+MappedFile::MappedFile(const Path &path) {
+	int fd = open(path.path().u8string().c_str(), O_RDONLY);
+	if (fd < 0) EXC(sb() << "Error opening file: " << path);
+
+	struct stat fileStatus;
+	if (fstat(fd, &fileStatus) != 0) {
+		close(fd);
+		EXC(sb() << "Error reading file size: " << path);
+	}
+	size = (int64_t)fileStatus.st_size;
+
+	// An empty file cannot be mapped.
+	if (size > 0) {
+		void *mappedData = mmap(nullptr, (size_t)size, PROT_READ, MAP_PRIVATE, fd, 0);
+		if (mappedData != MAP_FAILED) {
+			data = (const uint8_t *)mappedData;
+#if defined (POSIX_MADV_SEQUENTIAL)
+			posix_madvise(mappedData, (size_t)size, POSIX_MADV_SEQUENTIAL);
+#endif
+		}
+	}
+	close(fd); // The mapping stays valid after closing the file.
+
+	if (size > 0 && !data) EXC(sb() << "Error mapping file to memory: " << path);
+}
+
+MappedFile::~MappedFile() {
+	if (data) munmap((void *)data, (size_t)size);
+}
+
+#endif
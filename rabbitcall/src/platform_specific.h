@@ -3,3 +3,44 @@
 void setProcessPriorityToLow();
 FILE * openFileOrThrow(const filesystem::path &path, const string &mode, int64_t *fileSizeOut);
 
+// Maps a whole file to memory as read-only. The file should not be modified while it is mapped.
+class MappedFile {
+	const uint8_t *data = nullptr;
+	int64_t size = 0;
+
+public:
+	explicit MappedFile(const Path &path);
+	DISABLE_COPY_AND_MOVE(MappedFile);
+	~MappedFile();
+
+	const uint8_t * getData() const { return data; }
+	int64_t getSize() const { return size; }
+};
+
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// Detects changes in files under a set of directories (recursively). Uses inotify on Linux, change notifications on Windows,
+// and periodic directory scans on other platforms.
+class FileChangeWatcher {
+	struct PlatformState;
+
+	vector<Path> dirs;
+	function<bool(const string &path, bool isDirectory)> isRelevantChange;
+	unique_ptr<PlatformState> state;
+	map<string, pair<int64_t, int64_t>> fileSizesAndTimesByPath; // Used only when polling.
+
+	map<string, pair<int64_t, int64_t>> scanFileSizesAndTimes();
+	// Returns true if at least one relevant change was detected within the timeout (negative means no timeout).
+	bool waitForChangeEvents(int timeoutMilliseconds);
+
+public:
+	FileChangeWatcher(const vector<Path> &dirs, const function<bool(const string &path, bool isDirectory)> &isRelevantChange);
+	DISABLE_COPY_AND_MOVE(FileChangeWatcher);
+	~FileChangeWatcher();
+
+	// Blocks until a relevant change is detected and no more changes occur within the quiet period
+	// (so that e.g. saving several files at once triggers only one update).
+	void waitForChanges(int quietPeriodMilliseconds);
+};
+
@@ -0,0 +1,55 @@
+#include "pch.h"
+
+
+Arena::~Arena() {
+	clear();
+}
+
+void * Arena::allocateFromNewBlock(size_t size, size_t alignment) {
+	size_t blockSize = nextBlockSize;
+	if (size + alignment > blockSize) {
+		// Oversized allocations get their own block so that the current block can still be used for subsequent small allocations.
+		blocks.push_back(unique_ptr<uint8_t[]>(new uint8_t[size + alignment]));
+		uint8_t *p = (uint8_t *)(((uintptr_t)blocks.back().get() + (alignment - 1)) & ~(uintptr_t)(alignment - 1));
+		bytesAllocated += size;
+		return p;
+	}
+
+	blocks.push_back(unique_ptr<uint8_t[]>(new uint8_t[blockSize]));
+	currentBlockPos = blocks.back().get();
+	currentBlockEnd = currentBlockPos + blockSize;
+	nextBlockSize = min(nextBlockSize * 2, MAX_BLOCK_SIZE);
+	return allocate(size, alignment);
+}
+
+void Arena::merge(Arena *other) {
+	CHECK_NOT_NULL(other);
+	if (other == this) return;
+
+	blocks.reserve(blocks.size() + other->blocks.size());
+	for (auto &block : other->blocks) {
+		blocks.push_back(move(block));
+	}
+	destructors.insert(destructors.end(), other->destructors.begin(), other->destructors.end());
+	bytesAllocated += other->bytesAllocated;
+
+	other->blocks.clear();
+	other->destructors.clear();
+	other->currentBlockPos = nullptr;
+	other->currentBlockEnd = nullptr;
+	other->nextBlockSize = MIN_BLOCK_SIZE;
+	other->bytesAllocated = 0;
+}
+
+void Arena::clear() {
+	for (auto iter = destructors.rbegin(); iter != destructors.rend(); ++iter) {
+		iter->destroy(iter->object);
+	}
+	destructors.clear();
+	blocks.clear();
+	currentBlockPos = nullptr;
+	currentBlockEnd = nullptr;
+	nextBlockSize = MIN_BLOCK_SIZE;
+	bytesAllocated = 0;
+}
+
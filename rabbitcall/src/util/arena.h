@@ -0,0 +1,53 @@
+#pragma once
+
+// Allocates objects from large memory blocks that are freed all at once when the arena is destroyed. Objects are never freed individually,
+// but their destructors are called (in reverse order of creation) when the arena is destroyed. Not thread-safe: concurrent tasks should each
+// allocate from their own arena and merge it into a longer-lived arena afterwards.
+class Arena {
+	struct Destructor {
+		void (*destroy)(void *object) = nullptr;
+		void *object = nullptr;
+	};
+
+	static constexpr size_t MIN_BLOCK_SIZE = 16384;
+	static constexpr size_t MAX_BLOCK_SIZE = 1048576;
+
+	vector<unique_ptr<uint8_t[]>> blocks;
+	vector<Destructor> destructors;
+	uint8_t *currentBlockPos = nullptr;
+	uint8_t *currentBlockEnd = nullptr;
+	size_t nextBlockSize = MIN_BLOCK_SIZE;
+	size_t bytesAllocated = 0;
+
+	void * allocateFromNewBlock(size_t size, size_t alignment);
+
+public:
+	Arena() = default;
+	DISABLE_COPY_AND_MOVE(Arena);
+	~Arena();
+
+	void * allocate(size_t size, size_t alignment) {
+		uint8_t *p = (uint8_t *)(((uintptr_t)currentBlockPos + (alignment - 1)) & ~(uintptr_t)(alignment - 1));
+		if (!currentBlockPos || p + size > currentBlockEnd) return allocateFromNewBlock(size, alignment);
+		currentBlockPos = p + size;
+		bytesAllocated += size;
+		return p;
+	}
+
+	template<typename T, typename... Args>
+	T * create(Args&&... args) {
+		T *object = new (allocate(sizeof(T), alignof(T))) T(std::forward<Args>(args)...);
+		if (!std::is_trivially_destructible<T>::value) {
+			destructors.push_back({ [](void *o) { ((T *)o)->~T(); }, object });
+		}
+		return object;
+	}
+
+	// Takes over all objects and memory blocks of the other arena, leaving it empty.
+	void merge(Arena *other);
+	// Destroys all objects and frees the memory.
+	void clear();
+
+	size_t getBytesAllocated() { return bytesAllocated; }
+};
+
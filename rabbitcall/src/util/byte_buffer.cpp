@@ -131,5 +131,14 @@ void ByteBuffer::putVlq(uint64_t value) {
 	}
 }
 
+string ByteBuffer::getString() {
+	size_t length = (size_t)getVlq();
+	const char *ptr = (const char *)skipBytes(length);
+	return string(ptr, length);
+}
 
+void ByteBuffer::putString(const string &s) {
+	putVlq(s.size());
+	putBytes(s.data(), s.size());
+}
 
@@ -54,6 +54,10 @@ public:
 
 	uint64_t getVlq();
 	void putVlq(uint64_t value);
+
+	// Strings are stored as a VLQ length followed by the bytes.
+	string getString();
+	void putString(const string &s);
 };
 
 
@@ -0,0 +1,81 @@
+#include "pch.h"
+
+
+ChunkedOutput::ChunkedOutput(bool addByteOrderMark, bool useCrLfLineBreaks)
+	: useCrLfLineBreaks(useCrLfLineBreaks) {
+	if (addByteOrderMark) {
+		chunks.emplace_back("\xEF\xBB\xBF");
+		size += 3;
+	}
+}
+
+void ChunkedOutput::append(string &&data) {
+	if (data.empty()) return;
+
+	// The generators write LF line breaks, so usually the data can be stored as it is.
+	if (!useCrLfLineBreaks && !memchr(data.data(), '\r', data.size())) {
+		size += (int64_t)data.size();
+		chunks.push_back(move(data));
+	}
+	else {
+		string converted;
+		convertLineBreaks(&converted, data.data(), (int64_t)data.size(), useCrLfLineBreaks);
+		size += (int64_t)converted.size();
+		chunks.push_back(move(converted));
+	}
+}
+
+void StringBuilder::flushToChunkedOutput() {
+	if (chunkedOutput) {
+		chunkedOutput->append(move(buffer));
+		buffer = string();
+	}
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Hash128 ChunkedOutput::calculateHash() const {
+	vector<Hash128> chunkHashes;
+	for (const string &chunk : chunks) {
+		chunkHashes.push_back(calculateHash128(chunk.data(), chunk.size()));
+	}
+	return calculateHash128(chunkHashes.data(), chunkHashes.size() * sizeof(Hash128), (uint64_t)size);
+}
+
+bool ChunkedOutput::isSameAsFileContent(const Path &path) const {
+	int64_t fileSize;
+	AutoClosingFile file = openFileOrThrow(path.path(), "rb", &fileSize);
+	if (fileSize != size) return false;
+
+	vector<char> fileData;
+	for (const string &chunk : chunks) {
+		fileData.resize(chunk.size());
+		if (fread(fileData.data(), 1, chunk.size(), file) < chunk.size()) EXC(sb() << "Error reading file: " << path);
+		if (memcmp(fileData.data(), chunk.data(), chunk.size()) != 0) return false;
+	}
+	return true;
+}
+
+void ChunkedOutput::saveToFile(const Path &path) const {
+	Path parentPath = Path(path).path().parent_path();
+	if (!parentPath.empty() && !exists(parentPath.path())) {
+		EXC(sb() << "Directory does not exist for writing file: " << path);
+	}
+
+	Path tempPath = Path(path.toString() + ".tmp");
+	try {
+		{
+			AutoClosingFile file = openFileOrThrow(tempPath.path(), "wb", nullptr);
+			for (const string &chunk : chunks) {
+				if (fwrite(chunk.data(), 1, chunk.size(), file) < chunk.size()) EXC(sb() << "Error writing file: " << tempPath);
+			}
+		}
+		filesystem::rename(tempPath.path(), path.path());
+	}
+	catch (...) {
+		error_code errorCode;
+		filesystem::remove(tempPath.path(), errorCode);
+		throw;
+	}
+}
+
@@ -0,0 +1,25 @@
+#pragma once
+
+// Content of a generated file as a list of chunks, so that a large file doesn't need to be built in one contiguous buffer that is copied
+// whenever it grows. The line breaks are converted to the chosen style when a chunk is appended. The content can be compared to
+// an existing file and written to disk chunk by chunk.
+class ChunkedOutput {
+	bool useCrLfLineBreaks = false;
+	vector<string> chunks;
+	int64_t size = 0;
+
+public:
+	ChunkedOutput(bool addByteOrderMark, bool useCrLfLineBreaks);
+	DISABLE_COPY_AND_MOVE(ChunkedOutput);
+
+	void append(string &&data);
+	int64_t getSize() const { return size; }
+	// Combines the hashes of the chunks, so the result depends also on where the content was split into chunks (which is deterministic).
+	Hash128 calculateHash() const;
+
+	bool isSameAsFileContent(const Path &path) const;
+	// Writes a temporary file first and renames it over the target, so that the target file is never seen half-written.
+	void saveToFile(const Path &path) const;
+};
+
+
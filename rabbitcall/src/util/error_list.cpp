@@ -50,6 +50,11 @@ bool ErrorList::showErrors() {
 	return false;
 }
 
+void ErrorList::clear() {
+	lock_guard<recursive_mutex> lockGuard(lock);
+	errors.clear();
+}
+
 void ErrorList::addAll(ErrorList *list) {
 	lock_guard<recursive_mutex> lockGuard(lock);
 	lock_guard<recursive_mutex> oldListLockGuard(list->lock);
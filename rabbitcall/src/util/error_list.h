@@ -41,6 +41,7 @@ public:
 	void addError(const SourceLocation &location, const string &error);
 	bool hasErrors();
 	bool showErrors();
+	void clear();
 	void addAll(ErrorList *list);
 	bool runWithExceptionCheck(const function<void()> &task);
 };
@@ -54,13 +54,13 @@ string getRelativePathBetweenAbsolutePaths(const string &path, const string &bas
 	return Path(result).path().make_preferred().string();
 }
 
-void convertLineBreaks(ByteBuffer *target, const void *data, int64_t length, bool useCrLfInsteadOfLfOnly) {
+void convertLineBreaks(string *target, const void *data, int64_t length, bool useCrLfInsteadOfLfOnly) {
 	const uint8_t *sourceData = (const uint8_t *)data;
 	int64_t lineStart = 0;
 
 	auto copyCurrentLine = [&](int64_t lineEnd, int64_t nextLineStart) {
 		if (lineEnd > lineStart) {
-			target->putBytes(sourceData + lineStart, lineEnd - lineStart);
+			target->append((const char *)sourceData + lineStart, lineEnd - lineStart);
 		}
 		lineStart = nextLineStart;
 	};
@@ -69,8 +69,8 @@ void convertLineBreaks(ByteBuffer *target, const void *data, int64_t length, boo
 		char ch = sourceData[i];
 		if (ch == '\n') {
 			copyCurrentLine(i, i + 1);
-			if (useCrLfInsteadOfLfOnly) target->put<char>('\r');
-			target->put<char>('\n');
+			if (useCrLfInsteadOfLfOnly) target->push_back('\r');
+			target->push_back('\n');
 		}
 		else if (ch == '\r') {
 			copyCurrentLine(i, i + 1);
@@ -79,62 +79,47 @@ void convertLineBreaks(ByteBuffer *target, const void *data, int64_t length, boo
 	copyCurrentLine(length, length);
 }
 
-void convertUtf8OrIsoLatinToUtf8(ByteBuffer *result, const void *data, size_t size) {
-	const char *ptr = (const char *)data;
-	int64_t length = (int64_t)size;
-	for (int64_t i = 0; i < length;) {
-		unsigned char ch = ptr[i++];
-
-		if ((ch & 0x80) == 0) {
-			// ASCII 7-bit char.
-			result->put(ch);
-			continue;
+size_t getUtf8PrefixLengthNotNeedingConversion(const void *data, size_t size) {
+	// Uses the same rules as convertUtf8OrIsoLatinToUtf8().
+	const uint8_t *ptr = (const uint8_t *)data;
+	size_t i = 0;
+	while (i < size) {
+		// Skip runs of ASCII chars with vector instructions.
+		int64_t nonAsciiOffset = findFirstNonAsciiByte(ptr, (int64_t)size, (int64_t)i);
+		if (nonAsciiOffset < 0) return size;
+		i = (size_t)nonAsciiOffset;
+
+		uint8_t ch = ptr[i];
+		size_t numContinuationBytes;
+		if ((ch & 0xE0) == 0xC0) numContinuationBytes = 1;
+		else if ((ch & 0xF0) == 0xE0) numContinuationBytes = 2;
+		else if ((ch & 0xF8) == 0xF0) numContinuationBytes = 3;
+		else return i;
+
+		if (i + numContinuationBytes >= size) return i;
+		for (size_t j = 1; j <= numContinuationBytes; j++) {
+			if ((ptr[i + j] & 0xC0) != 0x80) return i;
 		}
+		i += 1 + numContinuationBytes;
+	}
+	return size;
+}
 
-		// Check if this is a valid multi-byte UTF-8 char.
-		if ((ch & 0xE0) == 0xC0) {
-			if (i < length) {
-				char ch2 = ptr[i];
-				if ((ch2 & 0xC0) == 0x80) {
-					result->put(ch);
-					result->put(ch2);
-					i += 1;
-					continue;
-				}
-			}
-		}
-		else if ((ch & 0xF0) == 0xE0) {
-			if (i + 1 < length) {
-				char ch2 = ptr[i];
-				char ch3 = ptr[i + 1];
-				if ((ch2 & 0xC0) == 0x80 && (ch3 & 0xC0) == 0x80) {
-					result->put(ch);
-					result->put(ch2);
-					result->put(ch3);
-					i += 2;
-					continue;
-				}
-			}
-		}
-		else if ((ch & 0xF8) == 0xF0) {
-			if (i + 2 < length) {
-				char ch2 = ptr[i];
-				char ch3 = ptr[i + 1];
-				char ch4 = ptr[i + 2];
-				if ((ch2 & 0xC0) == 0x80 && (ch3 & 0xC0) == 0x80 && (ch4 & 0xC0) == 0x80) {
-					result->put(ch);
-					result->put(ch2);
-					result->put(ch3);
-					result->put(ch4);
-					i += 3;
-					continue;
-				}
-			}
+void convertUtf8OrIsoLatinToUtf8(ByteBuffer *result, const void *data, size_t size) {
+	const uint8_t *ptr = (const uint8_t *)data;
+	size_t i = 0;
+	while (i < size) {
+		// Copy valid UTF-8 (usually ASCII) in blocks.
+		size_t validLength = getUtf8PrefixLengthNotNeedingConversion(ptr + i, size - i);
+		result->putBytes(ptr + i, validLength);
+		i += validLength;
+
+		if (i < size) {
+			// Invalid UTF-8 char => assume it is ISO-Latin-1 and convert to UTF-8.
+			uint8_t ch = ptr[i++];
+			uint8_t converted[2] = { (uint8_t)(0xc0 | (ch >> 6)), (uint8_t)(0x80 | (ch & 0x3F)) };
+			result->putBytes(converted, sizeof(converted));
 		}
-
-		// Invalid UTF-8 char => assume it is ISO-Latin-1 and convert to UTF-8.
-		result->put<uint8_t>(0xc0 | (ch >> 6));
-		result->put<uint8_t>(0x80 | (ch & 0x3F));
 	}
 }
 
@@ -150,9 +135,57 @@ u16string convertUtf8ToUtf16(const string &s) {
 	return result;
 }
 
-void convertUtf16ToUtf8(ByteBuffer *result, const u16string &s) {
-	string utf8 = convertUtf16ToUtf8(s);
-	result->putBytes(utf8.data(), utf8.size());
+void convertUtf16ToUtf8(ByteBuffer *result, const void *data, size_t numCodeUnits, bool swapBytes) {
+	const uint8_t *bytes = (const uint8_t *)data;
+	auto getCodeUnit = [&](size_t index) -> uint32_t {
+		char16_t ch;
+		memcpy(&ch, bytes + index * 2, 2);
+		if (swapBytes) ch = (char16_t)((ch << 8) | (ch >> 8));
+		return ch;
+	};
+
+	// Each code unit produces at most 3 bytes (a surrogate pair produces 4 bytes from 2 code units).
+	result->ensureRemainingCapacity(numCodeUnits * 3);
+	uint8_t *start = result->getBuffer() + result->getPosition();
+	uint8_t *target = start;
+
+	size_t i = 0;
+	while (i < numCodeUnits) {
+		// Copy ASCII chars in blocks.
+		int64_t numAsciiChars = copyAsciiPrefixFromUtf16ToUtf8(bytes + i * 2, (int64_t)(numCodeUnits - i), swapBytes, target);
+		i += (size_t)numAsciiChars;
+		target += numAsciiChars;
+		if (i >= numCodeUnits) break;
+
+		uint32_t codePoint = getCodeUnit(i++);
+		if (codePoint >= 0xD800 && codePoint < 0xE000) {
+			if (codePoint >= 0xDC00 || i >= numCodeUnits) EXC("Invalid UTF-16 surrogate pair in text");
+			uint32_t lowSurrogate = getCodeUnit(i++);
+			if (lowSurrogate < 0xDC00 || lowSurrogate >= 0xE000) EXC("Invalid UTF-16 surrogate pair in text");
+			codePoint = 0x10000 + ((codePoint - 0xD800) << 10) + (lowSurrogate - 0xDC00);
+		}
+
+		if (codePoint < 0x80) {
+			*target++ = (uint8_t)codePoint;
+		}
+		else if (codePoint < 0x800) {
+			*target++ = (uint8_t)(0xC0 | (codePoint >> 6));
+			*target++ = (uint8_t)(0x80 | (codePoint & 0x3F));
+		}
+		else if (codePoint < 0x10000) {
+			*target++ = (uint8_t)(0xE0 | (codePoint >> 12));
+			*target++ = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+			*target++ = (uint8_t)(0x80 | (codePoint & 0x3F));
+		}
+		else {
+			*target++ = (uint8_t)(0xF0 | (codePoint >> 18));
+			*target++ = (uint8_t)(0x80 | ((codePoint >> 12) & 0x3F));
+			*target++ = (uint8_t)(0x80 | ((codePoint >> 6) & 0x3F));
+			*target++ = (uint8_t)(0x80 | (codePoint & 0x3F));
+		}
+	}
+
+	result->setPosition(result->getPosition() + (target - start));
 }
 
 void convertAutoDetectedEncodingToUtf8(ByteBuffer *result, const uint8_t *data, size_t size) {
@@ -163,20 +196,11 @@ void convertAutoDetectedEncodingToUtf8(ByteBuffer *result, const uint8_t *data,
 	}
 	else if (size >= 2 && *(char16_t *)data == 0xFEFF) { // UTF-16 LE (or BE on big-endian machine)
 		size_t bomSizeChars = 1;
-		convertUtf16ToUtf8(result, u16string((const char16_t *)data + bomSizeChars, size / 2 - bomSizeChars));
+		convertUtf16ToUtf8(result, data + bomSizeChars * 2, size / 2 - bomSizeChars, false);
 	}
 	else if (size >= 2 && *(char16_t *)data == 0xFFFE) { // UTF-16 BE (or LE on big-endian machine)
-		ByteBuffer temp;
-		temp.resize(size);
-		uint8_t *dst = temp.getBuffer();
-		for (size_t i = 0; i < size; i += 2) {
-			char16_t t = *(char16_t *)(data + i);
-			t = ((t & 0xFF) << 8) | (t >> 8);
-			*(char16_t *)(dst + i) = t;
-		}
-
 		size_t bomSizeChars = 1;
-		convertUtf16ToUtf8(result, u16string((const char16_t *)temp.getBuffer() + bomSizeChars, size / 2 - bomSizeChars));
+		convertUtf16ToUtf8(result, data + bomSizeChars * 2, size / 2 - bomSizeChars, true);
 	}
 	else {
 		convertUtf8OrIsoLatinToUtf8(result, data, size);
@@ -201,6 +225,63 @@ void loadTextFileAsUtf8(ByteBuffer *result, const Path &path) {
 	stopWatch.mark("load text file / convert to utf-8");
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+Utf8TextFileContent::Utf8TextFileContent() {
+	clear();
+}
+
+Utf8TextFileContent::~Utf8TextFileContent() {
+}
+
+void Utf8TextFileContent::load(const Path &path, bool readIntoMemory) {
+	StopWatch stopWatch = app->createStopWatchForPerformanceMeasurement();
+	clear();
+
+	const uint8_t *fileData = nullptr;
+	size_t fileSize = 0;
+	if (readIntoMemory) {
+		readData = make_unique<ByteBuffer>();
+		loadBinaryFile(readData.get(), path);
+		fileData = readData->getBuffer();
+		fileSize = readData->getPosition();
+		stopWatch.mark("load text file / disk");
+	}
+	else {
+		mappedFile = make_unique<MappedFile>(path);
+		fileData = mappedFile->getData();
+		fileSize = (size_t)mappedFile->getSize();
+		stopWatch.mark("load text file / map to memory");
+	}
+
+	// Use the mapped/read data directly if it is UTF-8 or ASCII (with or without a BOM). UTF-16 and ISO-Latin-1 are converted.
+	bool isUtf16 = fileSize >= 2 && ((fileData[0] == 0xFF && fileData[1] == 0xFE) || (fileData[0] == 0xFE && fileData[1] == 0xFF));
+	if (!isUtf16) {
+		size_t bomSize = (fileSize >= 3 && fileData[0] == 0xEF && fileData[1] == 0xBB && fileData[2] == 0xBF) ? 3 : 0;
+		if (bomSize > 0 || getUtf8PrefixLengthNotNeedingConversion(fileData, fileSize) == fileSize) {
+			data = fileData + bomSize;
+			size = (int64_t)(fileSize - bomSize);
+			stopWatch.mark("load text file / validate utf-8");
+			return;
+		}
+	}
+
+	convertAutoDetectedEncodingToUtf8(&convertedData, fileData, fileSize);
+	data = convertedData.getBuffer();
+	size = convertedData.getPosition();
+	mappedFile.reset();
+	readData.reset();
+	stopWatch.mark("load text file / convert to utf-8");
+}
+
+void Utf8TextFileContent::clear() {
+	mappedFile.reset();
+	readData.reset();
+	convertedData.setPosition(0);
+	data = (const uint8_t *)"";
+	size = 0;
+}
+
 void saveBinaryFile(const Path &path, const void *data, size_t size) {
 	Path parentPath = Path(path).path().parent_path();
 	if (!parentPath.empty() && !exists(parentPath.path())) {
@@ -212,6 +293,19 @@ void saveBinaryFile(const Path &path, const void *data, size_t size) {
 	if (bytesWritten < size) EXC(sb() << "Error writing file: " << path);
 }
 
+void saveBinaryFileViaTemporaryFile(const Path &path, const void *data, size_t size) {
+	Path tempPath = Path(path.toString() + ".tmp");
+	try {
+		saveBinaryFile(tempPath, data, size);
+		filesystem::rename(tempPath.path(), path.path());
+	}
+	catch (...) {
+		error_code errorCode;
+		filesystem::remove(tempPath.path(), errorCode);
+		throw;
+	}
+}
+
 bool isPathSameOrDescendantOf(const string &p1, const string &p2) {
 	PathIterator i1(p1);
 	PathIterator i2(p2);
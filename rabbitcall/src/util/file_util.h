@@ -1,5 +1,7 @@
 #pragma once
 
+class MappedFile;
+
 // Wrap filesystem::path because it has an implicit constructor that could accidentally convert a UTF-8 string to a path as ISO-LATIN-1.
 class Path {
 	filesystem::path _path;
@@ -28,20 +30,49 @@ Path combinePathIfRelative(Path p1, Path p2);
 Path canonicalizePath(Path path);
 // Much faster than Boost filesystem::relative().
 string getRelativePathBetweenAbsolutePaths(const string &path, const string &base);
-void convertLineBreaks(ByteBuffer *target, const void *data, int64_t length, bool useCrLfInsteadOfLfOnly);
+void convertLineBreaks(string *target, const void *data, int64_t length, bool useCrLfInsteadOfLfOnly);
+// Returns the length of the beginning of the data that convertUtf8OrIsoLatinToUtf8() would leave unchanged (the whole size if the data is valid UTF-8).
+size_t getUtf8PrefixLengthNotNeedingConversion(const void *data, size_t size);
 void convertUtf8OrIsoLatinToUtf8(ByteBuffer *result, const void *data, size_t size);
 string convertUtf16ToUtf8(const u16string &s);
 u16string convertUtf8ToUtf16(const string &s);
-void convertUtf16ToUtf8(ByteBuffer *result, const u16string &s);
+// Converts UTF-16 code units (in native byte order unless swapping is requested) to UTF-8. Throws if there are invalid surrogate pairs.
+void convertUtf16ToUtf8(ByteBuffer *result, const void *data, size_t numCodeUnits, bool swapBytes);
 void convertAutoDetectedEncodingToUtf8(ByteBuffer *result, const uint8_t *data, size_t size);
 
 void loadBinaryFile(ByteBuffer *result, const Path &path);
 void loadTextFileAsUtf8(ByteBuffer *result, const Path &path);
 void saveBinaryFile(const Path &path, const void *data, size_t size);
+// Like saveBinaryFile(), but writes a temporary file first and renames it over the target, so that an interrupted write doesn't leave a truncated file.
+void saveBinaryFileViaTemporaryFile(const Path &path, const void *data, size_t size);
 bool isPathSameOrDescendantOf(const string &p1, const string &p2);
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
+// Contents of a text file as UTF-8. If the file is already valid UTF-8 (or ASCII), the data is viewed directly from the memory-mapped file without copying,
+// otherwise the file is converted to UTF-8 in a separate buffer. Reading a mapped file that another process has truncated crashes (SIGBUS),
+// so the file can be read into memory instead when that is likely.
+class Utf8TextFileContent {
+	unique_ptr<MappedFile> mappedFile;
+	unique_ptr<ByteBuffer> readData; // The file content if read into memory instead of mapping.
+	ByteBuffer convertedData;
+	const uint8_t *data = nullptr;
+	int64_t size = 0;
+
+public:
+	Utf8TextFileContent();
+	DISABLE_COPY_AND_MOVE(Utf8TextFileContent);
+	~Utf8TextFileContent();
+
+	void load(const Path &path, bool readIntoMemory);
+	void clear();
+
+	const uint8_t * getData() const { return data; }
+	int64_t getSize() const { return size; }
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
 // Closes a file automatically when this object is destroyed.
 class AutoClosingFile {
 	FILE *file = nullptr;
@@ -0,0 +1,75 @@
+#include "pch.h"
+
+
+string Hash128::toHexString() const {
+	char buffer[33];
+	snprintf(buffer, sizeof(buffer), "%016llx%016llx", (unsigned long long)high, (unsigned long long)low);
+	return string(buffer);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+static inline uint64_t rotateLeft64(uint64_t x, int r) {
+	return (x << r) | (x >> (64 - r));
+}
+
+static inline uint64_t finalizeMurmurHash64(uint64_t k) {
+	k ^= k >> 33;
+	k *= 0xff51afd7ed558ccdULL;
+	k ^= k >> 33;
+	k *= 0xc4ceb9fe1a85ec53ULL;
+	k ^= k >> 33;
+	return k;
+}
+
+Hash128 calculateHash128(const void *data, size_t size, uint64_t seed) {
+	const uint8_t *bytes = (const uint8_t *)data;
+	const size_t numBlocks = size / 16;
+
+	uint64_t h1 = seed;
+	uint64_t h2 = seed;
+	const uint64_t c1 = 0x87c37b91114253d5ULL;
+	const uint64_t c2 = 0x4cf5ad432745937fULL;
+
+	for (size_t i = 0; i < numBlocks; i++) {
+		uint64_t k1, k2;
+		memcpy(&k1, bytes + i * 16, 8);
+		memcpy(&k2, bytes + i * 16 + 8, 8);
+
+		k1 *= c1; k1 = rotateLeft64(k1, 31); k1 *= c2; h1 ^= k1;
+		h1 = rotateLeft64(h1, 27); h1 += h2; h1 = h1 * 5 + 0x52dce729;
+
+		k2 *= c2; k2 = rotateLeft64(k2, 33); k2 *= c1; h2 ^= k2;
+		h2 = rotateLeft64(h2, 31); h2 += h1; h2 = h2 * 5 + 0x38495ab5;
+	}
+
+	// Process the remaining 0..15 bytes.
+	const uint8_t *tail = bytes + numBlocks * 16;
+	uint64_t k1 = 0;
+	uint64_t k2 = 0;
+	size_t tailSize = size & 15;
+	for (size_t i = tailSize; i > 8; i--) {
+		k2 ^= (uint64_t)tail[i - 1] << ((i - 9) * 8);
+	}
+	if (tailSize > 8) {
+		k2 *= c2; k2 = rotateLeft64(k2, 33); k2 *= c1; h2 ^= k2;
+	}
+	for (size_t i = min(tailSize, (size_t)8); i > 0; i--) {
+		k1 ^= (uint64_t)tail[i - 1] << ((i - 1) * 8);
+	}
+	if (tailSize > 0) {
+		k1 *= c1; k1 = rotateLeft64(k1, 31); k1 *= c2; h1 ^= k1;
+	}
+
+	h1 ^= (uint64_t)size;
+	h2 ^= (uint64_t)size;
+	h1 += h2;
+	h2 += h1;
+	h1 = finalizeMurmurHash64(h1);
+	h2 = finalizeMurmurHash64(h2);
+	h1 += h2;
+	h2 += h1;
+
+	return Hash128(h1, h2);
+}
+
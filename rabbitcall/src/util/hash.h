@@ -0,0 +1,20 @@
+#pragma once
+
+// 128-bit non-cryptographic hash value, used for detecting changes in file contents.
+struct Hash128 {
+	uint64_t low = 0;
+	uint64_t high = 0;
+
+	Hash128() = default;
+	Hash128(uint64_t low, uint64_t high) : low(low), high(high) {
+	}
+
+	bool operator==(const Hash128 &o) const { return low == o.low && high == o.high; }
+	bool operator!=(const Hash128 &o) const { return !(*this == o); }
+	bool isZero() const { return low == 0 && high == 0; }
+	string toHexString() const;
+};
+
+// MurmurHash3 (x64, 128-bit variant).
+Hash128 calculateHash128(const void *data, size_t size, uint64_t seed = 0);
+
@@ -2,34 +2,60 @@
 
 
 void LineAndColumnNumberMap::build(const char *data, int64_t length) {
+	this->data = data;
+	dataLength = length;
+	indexedLength = 0;
 	lines.clear();
-	lineBreakCounts = LineBreakCounts();
-	
-	int64_t pos = 0;
-	int64_t currentLineNumber = 1;
 	lines.emplace_back(0, 1);
 
-	while (pos < length) {
-		char ch = data[pos];
-		if (ch == '\n') {
-			if (pos > 0 && data[pos - 1] == '\r') {
-				lineBreakCounts.crLfCount++;
-			}
-			else {
-				lineBreakCounts.lfCount++;
-			}
-
-			currentLineNumber++;
-			if (currentLineNumber > INT_MAX) throw logic_error("More than 2 billion lines in a file not supported");
-			lines.emplace_back(pos + 1, (int)currentLineNumber);
+	lineBreakCounts = LineBreakCounts();
+	countLineBreaks(data, length, &lineBreakCounts.lfCount, &lineBreakCounts.crLfCount);
+}
+
+void LineAndColumnNumberMap::releaseData(int64_t maxOffsetToIndex) {
+	indexUpToOffset(maxOffsetToIndex);
+	data = nullptr;
+}
+
+void LineAndColumnNumberMap::addLine(int64_t offset) {
+	int64_t lineNumber = (int64_t)lines.size() + 1;
+	if (lineNumber > INT_MAX) throw logic_error("More than 2 billion lines in a file not supported");
+	lines.emplace_back(offset, (int)lineNumber);
+}
+
+void LineAndColumnNumberMap::indexUpToOffset(int64_t offset) {
+	// Index also the line starting right after the offset, so that the line containing the offset is known to end there.
+	int64_t endOffset = min(offset + 1, dataLength);
+	if (!data || indexedLength >= endOffset) return;
+
+	while (indexedLength < endOffset) {
+		const char *lineBreak = (const char *)memchr(data + indexedLength, '\n', endOffset - indexedLength);
+		if (!lineBreak) {
+			indexedLength = endOffset;
+			break;
 		}
+		indexedLength = lineBreak - data + 1;
+		addLine(indexedLength);
+	}
+}
+
+void LineAndColumnNumberMap::indexUpToLineNumber(int64_t lineNumber) {
+	if (!data) return;
 
-		pos++;
+	while ((int64_t)lines.size() < lineNumber && indexedLength < dataLength) {
+		const char *lineBreak = (const char *)memchr(data + indexedLength, '\n', dataLength - indexedLength);
+		if (!lineBreak) {
+			indexedLength = dataLength;
+			break;
+		}
+		indexedLength = lineBreak - data + 1;
+		addLine(indexedLength);
 	}
 }
 
 LineAndColumnNumber LineAndColumnNumberMap::getLineAndColumnNumberByOffset(int64_t offset) {
 	LineAndColumnNumber result(1, 1);
+	indexUpToOffset(offset);
 	if (lines.empty()) {
 		return result;
 	}
@@ -68,8 +94,34 @@ LineBreakCounts LineAndColumnNumberMap::getLineBreakCounts() {
 }
 
 int64_t LineAndColumnNumberMap::getLineStartOffsetByLineNumber(int64_t lineNumber) {
+	indexUpToLineNumber(lineNumber);
 	if (lines.empty()) return 0;
 	return lines.at(clamp(lineNumber - 1, (int64_t)0, (int64_t)lines.size() - 1)).offset;
 }
 
+void LineAndColumnNumberMap::writeTo(ByteBuffer *b) {
+	b->putVlq(lineBreakCounts.lfCount);
+	b->putVlq(lineBreakCounts.crLfCount);
+	b->putVlq(lines.size());
+	int64_t previousOffset = 0;
+	for (const Line &line : lines) {
+		b->putVlq(line.offset - previousOffset);
+		previousOffset = line.offset;
+	}
+}
+
+void LineAndColumnNumberMap::readFrom(ByteBuffer *b) {
+	data = nullptr;
+	lines.clear();
+	lineBreakCounts.lfCount = (int64_t)b->getVlq();
+	lineBreakCounts.crLfCount = (int64_t)b->getVlq();
+	int64_t numLines = (int64_t)b->getVlq();
+	if (numLines > INT_MAX) EXC("More than 2 billion lines in a file not supported");
+	lines.reserve(numLines);
+	int64_t offset = 0;
+	for (int64_t i = 0; i < numLines; i++) {
+		offset += (int64_t)b->getVlq();
+		lines.emplace_back(offset, (int)(i + 1));
+	}
+}
 
@@ -24,7 +24,8 @@ struct LineBreakCounts {
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
-// Maps file offsets to line/column numbers.
+// Maps file offsets to line/column numbers. Line-breaks are counted when the map is built, but the line offsets are indexed lazily
+// up to the offset/line requested, so that large files with only a few lookups near the beginning don't need a full index.
 class LineAndColumnNumberMap {
 
 	struct Line {
@@ -38,12 +39,26 @@ class LineAndColumnNumberMap {
 
 	vector<Line> lines;
 	LineBreakCounts lineBreakCounts;
+	const char *data = nullptr; // Available only until releaseData() is called.
+	int64_t dataLength = 0;
+	int64_t indexedLength = 0; // Lines have been indexed up to this offset.
+
+	void addLine(int64_t offset);
+	void indexUpToOffset(int64_t offset);
+	void indexUpToLineNumber(int64_t lineNumber);
 
 public:
+	// The data must remain valid until releaseData() is called.
 	void build(const char *data, int64_t length);
+	// Indexes lines up to the given offset (later lookups must not be beyond it) and stops referencing the data.
+	void releaseData(int64_t maxOffsetToIndex);
+
 	LineAndColumnNumber getLineAndColumnNumberByOffset(int64_t offset);
 	LineBreakCounts getLineBreakCounts();
 	int64_t getLineStartOffsetByLineNumber(int64_t lineNumber);
-};
 
+	// Serialization for caching parse results (only the lines indexed so far are stored).
+	void writeTo(ByteBuffer *b);
+	void readFrom(ByteBuffer *b);
+};
 
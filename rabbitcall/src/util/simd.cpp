@@ -0,0 +1,366 @@
+#include "pch.h"
+
+#if defined (__x86_64__) || defined (_M_X64)
+#define SIMD_X86_64
+#include <immintrin.h>
+#if defined (_MSC_VER)
+#include <intrin.h>
+#define TARGET_AVX2
+#else
+#include <x86intrin.h>
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+enum class SimdInstructionSet {
+	SCALAR,
+	SSE2,
+	AVX2,
+};
+
+static SimdInstructionSet detectSimdInstructionSet() {
+#if defined (SIMD_X86_64)
+#if defined (_MSC_VER)
+	int cpuInfo[4];
+	__cpuid(cpuInfo, 0);
+	if (cpuInfo[0] >= 7) {
+		__cpuid(cpuInfo, 1);
+		bool osSupportsAvx = (cpuInfo[2] & (1 << 27)) != 0 && (cpuInfo[2] & (1 << 28)) != 0 && (_xgetbv(0) & 6) == 6;
+		__cpuidex(cpuInfo, 7, 0);
+		if (osSupportsAvx && (cpuInfo[1] & (1 << 5)) != 0) return SimdInstructionSet::AVX2;
+	}
+#else
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) return SimdInstructionSet::AVX2;
+#endif
+	return SimdInstructionSet::SSE2; // Always available on x86-64.
+#else
+	return SimdInstructionSet::SCALAR;
+#endif
+}
+
+static atomic<bool> simdEnabled{true}; // Read by the worker threads, so atomic even though it is normally changed only when they are idle.
+
+static SimdInstructionSet getSimdInstructionSet() {
+	static SimdInstructionSet instructionSet = detectSimdInstructionSet();
+	return simdEnabled ? instructionSet : SimdInstructionSet::SCALAR;
+}
+
+const char * getSimdInstructionSetName() {
+	switch (getSimdInstructionSet()) {
+	case SimdInstructionSet::AVX2: return "AVX2";
+	case SimdInstructionSet::SSE2: return "SSE2";
+	default: return "scalar";
+	}
+}
+
+void setSimdEnabled(bool enabled) {
+	simdEnabled = enabled;
+}
+
+uint64_t readCpuCycleCounter() {
+#if defined (SIMD_X86_64)
+	return __rdtsc();
+#else
+	return 0;
+#endif
+}
+
+static inline int countTrailingZeros(uint32_t v) {
+#if defined (_MSC_VER)
+	unsigned long index;
+	_BitScanForward(&index, v);
+	return (int)index;
+#else
+	return __builtin_ctz(v);
+#endif
+}
+
+static inline int countBits(uint32_t v) {
+#if defined (_MSC_VER)
+	v = v - ((v >> 1) & 0x55555555);
+	v = (v & 0x33333333) + ((v >> 2) & 0x33333333);
+	return (int)((((v + (v >> 4)) & 0x0F0F0F0F) * 0x01010101) >> 24);
+#else
+	return __builtin_popcount(v);
+#endif
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The vectorized versions compare the first and the last byte of the pattern at each position of a block simultaneously,
+// and compare the rest of the pattern only at positions where both of them match. They process the positions that fit fully
+// in the blocks and return the position where the caller should continue with the scalar version.
+
+static int64_t findByteSequenceScalar(const uint8_t *data, int64_t dataSize, const uint8_t *pattern, int64_t patternSize, int64_t startOffset) {
+	uint8_t firstByte = pattern[0];
+	int64_t endOffset = dataSize - patternSize + 1;
+	for (int64_t i = startOffset; i < endOffset; i++) {
+		if (data[i] == firstByte && memcmp(data + i, pattern, patternSize) == 0) {
+			return i;
+		}
+	}
+	return -1;
+}
+
+#if defined (SIMD_X86_64)
+
+static int64_t findByteSequenceSse2(const uint8_t *data, int64_t dataSize, const uint8_t *pattern, int64_t patternSize, int64_t *offset) {
+	const __m128i first = _mm_set1_epi8((char)pattern[0]);
+	const __m128i last = _mm_set1_epi8((char)pattern[patternSize - 1]);
+	int64_t i = *offset;
+	for (; i + patternSize - 1 + 16 <= dataSize; i += 16) {
+		__m128i blockFirst = _mm_loadu_si128((const __m128i *)(data + i));
+		__m128i blockLast = _mm_loadu_si128((const __m128i *)(data + i + patternSize - 1));
+		uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(blockFirst, first), _mm_cmpeq_epi8(blockLast, last)));
+		while (mask != 0) {
+			int64_t pos = i + countTrailingZeros(mask);
+			if (memcmp(data + pos, pattern, patternSize) == 0) return pos;
+			mask &= mask - 1;
+		}
+	}
+	*offset = i;
+	return -1;
+}
+
+TARGET_AVX2 static int64_t findByteSequenceAvx2(const uint8_t *data, int64_t dataSize, const uint8_t *pattern, int64_t patternSize, int64_t *offset) {
+	const __m256i first = _mm256_set1_epi8((char)pattern[0]);
+	const __m256i last = _mm256_set1_epi8((char)pattern[patternSize - 1]);
+	int64_t i = *offset;
+	for (; i + patternSize - 1 + 32 <= dataSize; i += 32) {
+		__m256i blockFirst = _mm256_loadu_si256((const __m256i *)(data + i));
+		__m256i blockLast = _mm256_loadu_si256((const __m256i *)(data + i + patternSize - 1));
+		uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(blockFirst, first), _mm256_cmpeq_epi8(blockLast, last)));
+		while (mask != 0) {
+			int64_t pos = i + countTrailingZeros(mask);
+			if (memcmp(data + pos, pattern, patternSize) == 0) return pos;
+			mask &= mask - 1;
+		}
+	}
+	*offset = i;
+	return -1;
+}
+
+#endif
+
+int64_t findByteSequence(const void *data, int64_t dataSize, const void *pattern, int64_t patternSize, int64_t startOffset) {
+	if (patternSize <= 0) EXC("Search pattern cannot be empty.");
+	const uint8_t *bytes = (const uint8_t *)data;
+	const uint8_t *patternBytes = (const uint8_t *)pattern;
+	int64_t offset = max((int64_t)0, startOffset);
+
+#if defined (SIMD_X86_64)
+	SimdInstructionSet instructionSet = getSimdInstructionSet();
+	int64_t result = -1;
+	if (instructionSet == SimdInstructionSet::AVX2) result = findByteSequenceAvx2(bytes, dataSize, patternBytes, patternSize, &offset);
+	else if (instructionSet == SimdInstructionSet::SSE2) result = findByteSequenceSse2(bytes, dataSize, patternBytes, patternSize, &offset);
+	if (result >= 0) return result;
+#endif
+
+	return findByteSequenceScalar(bytes, dataSize, patternBytes, patternSize, offset);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+#if defined (SIMD_X86_64)
+
+static int64_t skipAsciiBytesSse2(const uint8_t *data, int64_t dataSize, int64_t offset) {
+	for (; offset + 16 <= dataSize; offset += 16) {
+		uint32_t mask = (uint32_t)_mm_movemask_epi8(_mm_loadu_si128((const __m128i *)(data + offset)));
+		if (mask != 0) return offset + countTrailingZeros(mask);
+	}
+	return offset;
+}
+
+TARGET_AVX2 static int64_t skipAsciiBytesAvx2(const uint8_t *data, int64_t dataSize, int64_t offset) {
+	for (; offset + 32 <= dataSize; offset += 32) {
+		uint32_t mask = (uint32_t)_mm256_movemask_epi8(_mm256_loadu_si256((const __m256i *)(data + offset)));
+		if (mask != 0) return offset + countTrailingZeros(mask);
+	}
+	return offset;
+}
+
+#endif
+
+int64_t findFirstNonAsciiByte(const void *data, int64_t dataSize, int64_t startOffset) {
+	const uint8_t *bytes = (const uint8_t *)data;
+	int64_t offset = max((int64_t)0, startOffset);
+
+#if defined (SIMD_X86_64)
+	SimdInstructionSet instructionSet = getSimdInstructionSet();
+	if (instructionSet == SimdInstructionSet::AVX2) offset = skipAsciiBytesAvx2(bytes, dataSize, offset);
+	else if (instructionSet == SimdInstructionSet::SSE2) offset = skipAsciiBytesSse2(bytes, dataSize, offset);
+#endif
+
+	for (; offset < dataSize; offset++) {
+		if ((bytes[offset] & 0x80) != 0) return offset;
+	}
+	return -1;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+int64_t copyAsciiPrefixFromUtf16ToUtf8(const void *utf16Data, int64_t numCodeUnits, bool swapBytes, uint8_t *target) {
+	const uint8_t *bytes = (const uint8_t *)utf16Data;
+	int64_t i = 0;
+
+#if defined (SIMD_X86_64)
+	// Convert 16 code units at a time as long as they are all ASCII (the high byte is zero and the low byte is below 0x80).
+	const __m128i nonAsciiBits = _mm_set1_epi16((short)0xFF80);
+	for (; i + 16 <= numCodeUnits; i += 16) {
+		__m128i v1 = _mm_loadu_si128((const __m128i *)(bytes + i * 2));
+		__m128i v2 = _mm_loadu_si128((const __m128i *)(bytes + i * 2 + 16));
+		if (swapBytes) {
+			v1 = _mm_or_si128(_mm_slli_epi16(v1, 8), _mm_srli_epi16(v1, 8));
+			v2 = _mm_or_si128(_mm_slli_epi16(v2, 8), _mm_srli_epi16(v2, 8));
+		}
+		__m128i nonAscii = _mm_and_si128(_mm_or_si128(v1, v2), nonAsciiBits);
+		if (_mm_movemask_epi8(_mm_cmpeq_epi8(nonAscii, _mm_setzero_si128())) != 0xFFFF) break;
+		_mm_storeu_si128((__m128i *)(target + i), _mm_packus_epi16(v1, v2));
+	}
+#endif
+
+	for (; i < numCodeUnits; i++) {
+		char16_t ch;
+		memcpy(&ch, bytes + i * 2, 2);
+		if (swapBytes) ch = (char16_t)((ch << 8) | (ch >> 8));
+		if (ch >= 0x80) break;
+		target[i] = (uint8_t)ch;
+	}
+	return i;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// The vectorized versions compare each block to LF and the same block shifted back by one byte to CR, and count the matching bits.
+// They start from offset 1 so that the preceding byte is always available, and return the position where the caller should continue.
+
+#if defined (SIMD_X86_64)
+
+static int64_t countLineBreaksSse2(const uint8_t *data, int64_t dataSize, int64_t *lfCount, int64_t *crLfCount) {
+	const __m128i lf = _mm_set1_epi8('\n');
+	const __m128i cr = _mm_set1_epi8('\r');
+	int64_t i = 1;
+	for (; i + 16 <= dataSize; i += 16) {
+		__m128i lfMatches = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i)), lf);
+		__m128i crMatches = _mm_cmpeq_epi8(_mm_loadu_si128((const __m128i *)(data + i - 1)), cr);
+		*lfCount += countBits((uint32_t)_mm_movemask_epi8(lfMatches));
+		*crLfCount += countBits((uint32_t)_mm_movemask_epi8(_mm_and_si128(lfMatches, crMatches)));
+	}
+	return i;
+}
+
+TARGET_AVX2 static int64_t countLineBreaksAvx2(const uint8_t *data, int64_t dataSize, int64_t *lfCount, int64_t *crLfCount) {
+	const __m256i lf = _mm256_set1_epi8('\n');
+	const __m256i cr = _mm256_set1_epi8('\r');
+	int64_t i = 1;
+	for (; i + 32 <= dataSize; i += 32) {
+		__m256i lfMatches = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(data + i)), lf);
+		__m256i crMatches = _mm256_cmpeq_epi8(_mm256_loadu_si256((const __m256i *)(data + i - 1)), cr);
+		*lfCount += countBits((uint32_t)_mm256_movemask_epi8(lfMatches));
+		*crLfCount += countBits((uint32_t)_mm256_movemask_epi8(_mm256_and_si256(lfMatches, crMatches)));
+	}
+	return i;
+}
+
+#endif
+
+void countLineBreaks(const void *data, int64_t dataSize, int64_t *lfOnlyCount, int64_t *crLfCount) {
+	const uint8_t *bytes = (const uint8_t *)data;
+	int64_t lfCount = 0; // All LFs, including those in CR-LF.
+	*crLfCount = 0;
+	int64_t i = 0;
+
+#if defined (SIMD_X86_64)
+	if (dataSize > 0) {
+		if (bytes[0] == '\n') lfCount++;
+		SimdInstructionSet instructionSet = getSimdInstructionSet();
+		if (instructionSet == SimdInstructionSet::AVX2) i = countLineBreaksAvx2(bytes, dataSize, &lfCount, crLfCount);
+		else if (instructionSet == SimdInstructionSet::SSE2) i = countLineBreaksSse2(bytes, dataSize, &lfCount, crLfCount);
+		else i = 1;
+	}
+#endif
+
+	for (; i < dataSize; i++) {
+		if (bytes[i] == '\n') {
+			lfCount++;
+			if (i > 0 && bytes[i - 1] == '\r') (*crLfCount)++;
+		}
+	}
+	*lfOnlyCount = lfCount - *crLfCount;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+ByteSet::ByteSet(const string &chars) {
+	if ((int)chars.size() > MAX_VALUES) EXC(sb() << "Too many values in a byte set: " << chars.size());
+	for (char ch : chars) {
+		uint8_t value = (uint8_t)ch;
+		if (!containsByValue[value]) {
+			containsByValue[value] = true;
+			values[numValues++] = value;
+		}
+	}
+}
+
+// The vectorized versions compare each block to all the values in the set and return the position where the caller should continue.
+
+#if defined (SIMD_X86_64)
+
+static int64_t findFirstByteInSetSse2(const uint8_t *data, int64_t dataSize, const ByteSet &set, int64_t *offset) {
+	__m128i values[ByteSet::MAX_VALUES];
+	for (int i = 0; i < set.numValues; i++) {
+		values[i] = _mm_set1_epi8((char)set.values[i]);
+	}
+	int64_t i = *offset;
+	for (; i + 16 <= dataSize; i += 16) {
+		__m128i block = _mm_loadu_si128((const __m128i *)(data + i));
+		__m128i matches = _mm_setzero_si128();
+		for (int j = 0; j < set.numValues; j++) {
+			matches = _mm_or_si128(matches, _mm_cmpeq_epi8(block, values[j]));
+		}
+		uint32_t mask = (uint32_t)_mm_movemask_epi8(matches);
+		if (mask != 0) return i + countTrailingZeros(mask);
+	}
+	*offset = i;
+	return -1;
+}
+
+TARGET_AVX2 static int64_t findFirstByteInSetAvx2(const uint8_t *data, int64_t dataSize, const ByteSet &set, int64_t *offset) {
+	__m256i values[ByteSet::MAX_VALUES];
+	for (int i = 0; i < set.numValues; i++) {
+		values[i] = _mm256_set1_epi8((char)set.values[i]);
+	}
+	int64_t i = *offset;
+	for (; i + 32 <= dataSize; i += 32) {
+		__m256i block = _mm256_loadu_si256((const __m256i *)(data + i));
+		__m256i matches = _mm256_setzero_si256();
+		for (int j = 0; j < set.numValues; j++) {
+			matches = _mm256_or_si256(matches, _mm256_cmpeq_epi8(block, values[j]));
+		}
+		uint32_t mask = (uint32_t)_mm256_movemask_epi8(matches);
+		if (mask != 0) return i + countTrailingZeros(mask);
+	}
+	*offset = i;
+	return -1;
+}
+
+#endif
+
+int64_t findFirstByteInSet(const void *data, int64_t dataSize, const ByteSet &set, int64_t startOffset) {
+	const uint8_t *bytes = (const uint8_t *)data;
+	int64_t offset = max((int64_t)0, startOffset);
+
+#if defined (SIMD_X86_64)
+	SimdInstructionSet instructionSet = getSimdInstructionSet();
+	int64_t result = -1;
+	if (instructionSet == SimdInstructionSet::AVX2) result = findFirstByteInSetAvx2(bytes, dataSize, set, &offset);
+	else if (instructionSet == SimdInstructionSet::SSE2) result = findFirstByteInSetSse2(bytes, dataSize, set, &offset);
+	if (result >= 0) return result;
+#endif
+
+	for (; offset < dataSize; offset++) {
+		if (set.containsByValue[bytes[offset]]) return offset;
+	}
+	return -1;
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+// Vectorized implementations of the hottest scanning loops. The implementation is selected at runtime based on the CPU:
+// AVX2 or SSE2 on x86-64, and plain scalar code on other platforms.
+
+// Name of the instruction set selected for this CPU (e.g. "AVX2").
+const char * getSimdInstructionSetName();
+
+// Makes all functions use the scalar implementations, e.g. for comparing performance in benchmarks. Takes effect in other threads
+// for the subsequent calls (calls already running in them are not affected).
+void setSimdEnabled(bool enabled);
+
+// Reads the CPU time-stamp counter (approximately clock cycles) for benchmarking, or returns 0 if not supported on this platform.
+uint64_t readCpuCycleCounter();
+
+// Returns the offset of the first occurrence of the pattern in the data at or after the start offset, or -1 if there are none.
+int64_t findByteSequence(const void *data, int64_t dataSize, const void *pattern, int64_t patternSize, int64_t startOffset = 0);
+
+// Returns the offset of the first byte that is not 7-bit ASCII at or after the start offset, or -1 if there are none.
+int64_t findFirstNonAsciiByte(const void *data, int64_t dataSize, int64_t startOffset = 0);
+
+// Copies UTF-16 code units to the target as UTF-8 until the first one that is not 7-bit ASCII. The code units are in native byte order unless swapping is requested.
+// Returns the number of code units copied (which is also the number of bytes written).
+int64_t copyAsciiPrefixFromUtf16ToUtf8(const void *utf16Data, int64_t numCodeUnits, bool swapBytes, uint8_t *target);
+
+// Counts LF line-breaks that are preceded by a CR (CR-LF) and those that are not (LF only).
+void countLineBreaks(const void *data, int64_t dataSize, int64_t *lfOnlyCount, int64_t *crLfCount);
+
+// Set of byte values (at most 16) to search for with findFirstByteInSet().
+struct ByteSet {
+	static const int MAX_VALUES = 16;
+	uint8_t values[MAX_VALUES] = {};
+	int numValues = 0;
+	bool containsByValue[256] = {};
+
+	explicit ByteSet(const string &chars);
+};
+
+// Returns the offset of the first byte that belongs to the set at or after the start offset, or -1 if there are none.
+int64_t findFirstByteInSet(const void *data, int64_t dataSize, const ByteSet &set, int64_t startOffset = 0);
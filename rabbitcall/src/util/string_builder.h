@@ -1,10 +1,15 @@
 #pragma once
 
+class ChunkedOutput;
+
 class StringBuilder {
 public:
 	string buffer;
 	int lineIndent = 0;
 	static const char indentChar = '\t';
+	// If set, the buffer is moved to the chunked output at the start of a line whenever it has grown larger than the chunk size.
+	ChunkedOutput *chunkedOutput = nullptr;
+	static const size_t chunkedOutputChunkSize = 1 << 20;
 
 	StringBuilder() {
 	}
@@ -19,6 +24,7 @@ public:
 	StringBuilder & operator=(StringBuilder &&other) noexcept {
 		buffer = move(other.buffer);
 		lineIndent = other.lineIndent;
+		chunkedOutput = other.chunkedOutput;
 		return *this;
 	}
 
@@ -30,7 +36,15 @@ public:
 		return *this;
 	}
 
+	// Moves the buffered content to the chunked output (if used).
+	void flushToChunkedOutput();
+
+	void flushToChunkedOutputIfFull() {
+		if (chunkedOutput && buffer.size() >= chunkedOutputChunkSize) flushToChunkedOutput();
+	}
+
 	StringBuilder & appendIndent() {
+		flushToChunkedOutputIfFull();
 		for (int i = 0; i < lineIndent; i++) {
 			buffer.push_back(indentChar);
 		}
@@ -51,6 +65,14 @@ public:
 		return *this;
 	}
 
+	// Appends the content of another builder, e.g. output generated in another thread.
+	StringBuilder & append(StringBuilder &&other) {
+		if (buffer.empty()) buffer = move(other.buffer);
+		else buffer.append(other.buffer);
+		flushToChunkedOutputIfFull();
+		return *this;
+	}
+
 	// ReSharper disable once CppNonExplicitConversionOperator
 	operator string() const {
 		return buffer;
@@ -70,6 +92,7 @@ StringBuilder & operator<<(StringBuilder &&b, const T &o) { return operator<<(b,
 
 inline StringBuilder & operator<<(StringBuilder &b, const string &o) { b.buffer.append(o); return b; }
 inline StringBuilder & operator<<(StringBuilder &b, const char *o) { b.buffer.append(o); return b; }
+inline StringBuilder & operator<<(StringBuilder &b, const StringView &o) { b.buffer.append(o.ptr, o.length); return b; }
 inline StringBuilder & operator<<(StringBuilder &b, char o) { b.buffer.push_back(o); return b; }
 inline StringBuilder & operator<<(StringBuilder &b, int64_t o) { b.buffer.append(to_string(o)); return b; }
 inline StringBuilder & operator<<(StringBuilder &b, uint64_t o) { b.buffer.append(to_string(o)); return b; }
@@ -129,6 +152,12 @@ public:
 		*buffer << s;
 	}
 
+	// Starts a new element, which the caller writes directly to the returned buffer.
+	StringBuilder & appendElement() {
+		checkIfFirstElement();
+		return *buffer;
+	}
+
 	void finish() {
 		if (!isEmpty) {
 			*buffer << suffixIfNotEmpty;
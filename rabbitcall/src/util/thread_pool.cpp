@@ -1,8 +1,33 @@
 #include "pch.h"
 
 
-bool ThreadPool::TaskSet::isEmptyNoSync() {
-	return numQueuedTasks <= 0 && numRunningTasks <= 0;
+// The pool and queue index of the current thread if it is a pool thread.
+static thread_local ThreadPool *currentThreadPool = nullptr;
+static thread_local int currentThreadIndex = -1;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void ThreadPool::TaskSet::notifyWaitingThreads() {
+	// A waiting thread increments the number of waiting threads before checking the counters, so either it sees the updated
+	// counters or this sees the waiting thread and wakes it up.
+	if (numWaitingThreads > 0) {
+		lock_guard<mutex> _(waitLock);
+		waitCondition.notify_all();
+	}
+}
+
+
+void ThreadPool::TaskSet::onTaskFinished() {
+	int n = numUnfinishedTasks;
+	while (n > 1) {
+		if (numUnfinishedTasks.compare_exchange_weak(n, n - 1)) return;
+	}
+
+	// This may be the last task, after which the waiting thread may return and destroy the set => reach zero while holding the lock,
+	// which the waiting thread acquires before returning.
+	lock_guard<mutex> _(waitLock);
+	if (--numUnfinishedTasks < 0) EXC("Number of unfinished tasks in thread pool cannot become negative");
+	waitCondition.notify_all();
 }
 
 ThreadPool::TaskSet::TaskSet(ThreadPool *pool)
@@ -14,15 +39,33 @@ void ThreadPool::TaskSet::addTask(const function<void()> &task) {
 }
 
 bool ThreadPool::TaskSet::isEmpty() {
-	lock_guard<mutex> _(pool->lock);
-	return isEmptyNoSync();
+	return numUnfinishedTasks <= 0;
 }
 
 void ThreadPool::TaskSet::waitUntilEmpty() {
-	unique_lock<mutex> currentLock(pool->lock);
-	while (!isEmptyNoSync()) {
-		emptyCondition.wait_for(currentLock, std::chrono::milliseconds(1000));
+	while (!isEmpty()) {
+		TaskRef task = pool->takeQueuedTaskFromSet(this);
+		if (!task.valid) {
+			// The remaining tasks are running in other threads => sleep until they complete or enqueue new tasks.
+			unique_lock<mutex> currentLock(waitLock);
+			numWaitingThreads++;
+			waitCondition.wait(currentLock, [&] { return numUnfinishedTasks <= 0 || numQueuedTasks > 0; });
+			numWaitingThreads--;
+			continue;
+		}
+
+		try {
+			task.task();
+		}
+		catch (...) {
+			pool->finishTask(task);
+			throw;
+		}
+		pool->finishTask(task);
 	}
+
+	// Wait until the thread that finished the last task has released the lock.
+	lock_guard<mutex> _(waitLock);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -34,60 +77,138 @@ ThreadPool::TaskRef::TaskRef(const function<void()> &task, TaskSet *taskSet)
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 void ThreadPool::addTaskFromSet(TaskSet *taskSet, const function<void()> &task) {
-	lock_guard<mutex> _(lock);
-	taskQueue.emplace_back(task, taskSet);
-	threadWakeupCondition.notify_one();
+	// The set must not appear empty while the task is being queued, but the queued task counters are incremented only when the task
+	// is actually in the queue (under the queue lock, like when taking the task), so that woken up threads do not spin waiting for it.
+	if (taskSet) {
+		taskSet->numUnfinishedTasks++;
+	}
+
+	TaskQueue *queue = (currentThreadPool == this) ? threadQueues.at(currentThreadIndex).get() : &sharedQueue;
+	{
+		lock_guard<mutex> _(queue->lock);
+		queue->tasks.emplace_back(task, taskSet);
+		numQueuedTasks++;
+		if (taskSet) {
+			taskSet->numQueuedTasks++;
+		}
+	}
+
 	if (taskSet) {
-		taskSet->numQueuedTasks++;
+		taskSet->notifyWaitingThreads();
+	}
+
+	// Same as with TaskSet::notifyWaitingThreads(), a pool thread increments the number of sleeping threads before checking for queued tasks.
+	if (numSleepingThreads > 0) {
+		lock_guard<mutex> _(lock);
+		threadWakeupCondition.notify_one();
+	}
+}
+
+ThreadPool::TaskRef ThreadPool::takeTaskFromQueue(TaskQueue *queue, bool newestFirst, TaskSet *taskSetIfOnlyFromSet) {
+	lock_guard<mutex> _(queue->lock);
+	if (queue->tasks.empty()) return TaskRef();
+
+	TaskRef task;
+	if (taskSetIfOnlyFromSet) {
+		auto isFromSet = [&](const TaskRef &t) { return t.taskSet == taskSetIfOnlyFromSet; };
+		if (newestFirst) {
+			auto iter = find_if(queue->tasks.rbegin(), queue->tasks.rend(), isFromSet);
+			if (iter == queue->tasks.rend()) return TaskRef();
+			task = move(*iter);
+			queue->tasks.erase(next(iter).base());
+		}
+		else {
+			auto iter = find_if(queue->tasks.begin(), queue->tasks.end(), isFromSet);
+			if (iter == queue->tasks.end()) return TaskRef();
+			task = move(*iter);
+			queue->tasks.erase(iter);
+		}
+	}
+	else if (newestFirst) {
+		task = move(queue->tasks.back());
+		queue->tasks.pop_back();
+	}
+	else {
+		task = move(queue->tasks.front());
+		queue->tasks.pop_front();
+	}
+
+	numQueuedTasks--;
+	if (task.taskSet) {
+		if (--task.taskSet->numQueuedTasks < 0) EXC("Number of queued tasks in thread pool cannot become negative");
+	}
+	return task;
+}
+
+ThreadPool::TaskRef ThreadPool::takeQueuedTask(int threadIndex) {
+	// Own tasks are taken newest first so that the data they use is likely still in the cache, and tasks of other threads oldest first,
+	// because they are likely to be the largest ones (e.g. the top level of a directory tree).
+	TaskRef task = takeTaskFromQueue(threadQueues.at(threadIndex).get(), true, nullptr);
+	if (task.valid) return task;
+
+	task = takeTaskFromQueue(&sharedQueue, false, nullptr);
+	if (task.valid) return task;
+
+	for (int i = 1; i < numThreads; i++) {
+		task = takeTaskFromQueue(threadQueues.at((threadIndex + i) % numThreads).get(), false, nullptr);
+		if (task.valid) return task;
+	}
+	return TaskRef();
+}
+
+ThreadPool::TaskRef ThreadPool::takeQueuedTaskFromSet(TaskSet *taskSet) {
+	if (taskSet->numQueuedTasks <= 0) return TaskRef();
+
+	if (currentThreadPool == this) {
+		TaskRef task = takeTaskFromQueue(threadQueues.at(currentThreadIndex).get(), true, taskSet);
+		if (task.valid) return task;
+	}
+
+	TaskRef task = takeTaskFromQueue(&sharedQueue, false, taskSet);
+	if (task.valid) return task;
+
+	for (int i = 0; i < numThreads; i++) {
+		if (currentThreadPool == this && i == currentThreadIndex) continue;
+		task = takeTaskFromQueue(threadQueues.at(i).get(), false, taskSet);
+		if (task.valid) return task;
+	}
+	return TaskRef();
+}
+
+void ThreadPool::finishTask(const TaskRef &task) {
+	if (task.taskSet) {
+		task.taskSet->onTaskFinished();
 	}
 }
 
-void ThreadPool::runPoolThread() {
+void ThreadPool::runPoolThread(int threadIndex) {
 	try {
-		TaskRef task;
+		currentThreadPool = this;
+		currentThreadIndex = threadIndex;
 
 		{
 			unique_lock<mutex> currentLock(lock);
 			numRunningThreads++;
 		}
 
-		while (true) {
-			{
-				unique_lock<mutex> currentLock(lock);
-
-				if (stopping) {
-					numRunningThreads--;
-					threadStopWaitCondition.notify_all();
-					break;
-				}
-
-				// Check if a task was completed on the previous round of the loop.
-				if (task.valid) {
-					if (task.taskSet) {
-						if (--task.taskSet->numRunningTasks < 0) EXC("Number of running tasks in thread pool cannot become negative");
-						if (task.taskSet->isEmptyNoSync()) {
-							task.taskSet->emptyCondition.notify_all();
-						}
-					}
-					task.valid = false;
-				}
-				
-				if (taskQueue.empty()) {
-					threadWakeupCondition.wait_for(currentLock, std::chrono::milliseconds(1000));
-				}
-				else {
-					task = taskQueue.front();
-					taskQueue.pop_front();
-					if (task.taskSet) {
-						if (--task.taskSet->numQueuedTasks < 0) EXC("Number of queued tasks in thread pool cannot become negative");
-						task.taskSet->numRunningTasks++;
-					}
-				}
-			}
-
+		while (!stopping) {
+			TaskRef task = takeQueuedTask(threadIndex);
 			if (task.valid) {
 				task.task();
+				finishTask(task);
+				continue;
 			}
+
+			unique_lock<mutex> currentLock(lock);
+			numSleepingThreads++;
+			threadWakeupCondition.wait(currentLock, [&] { return stopping || numQueuedTasks > 0; });
+			numSleepingThreads--;
+		}
+
+		{
+			unique_lock<mutex> currentLock(lock);
+			numRunningThreads--;
+			threadStopWaitCondition.notify_all();
 		}
 	}
 	catch (const exception &e) {
@@ -102,6 +223,9 @@ void ThreadPool::runPoolThread() {
 
 ThreadPool::ThreadPool(int numThreads)
 	: numThreads(numThreads) {
+	for (int i = 0; i < numThreads; i++) {
+		threadQueues.push_back(make_unique<TaskQueue>());
+	}
 }
 
 ThreadPool::~ThreadPool() {
@@ -110,8 +234,8 @@ ThreadPool::~ThreadPool() {
 
 void ThreadPool::start() {
 	for (int i = 0; i < numThreads; i++) {
-		shared_ptr<thread> t = make_shared<thread>([this] {
-			runPoolThread();
+		shared_ptr<thread> t = make_shared<thread>([this, i] {
+			runPoolThread(i);
 		});
 		threads.push_back(t);
 	}
@@ -1,17 +1,23 @@
 #pragma once
 
+// Each pool thread has its own task queue: tasks enqueued by a pool thread go to its own queue, where they are taken in LIFO order,
+// and an idle thread steals the oldest tasks from the other threads' queues. Tasks enqueued by other threads go to a shared queue.
 class ThreadPool {
 
 public:
 	// A set of tasks that can be run in multiple threads. The main thread can wait until all tasks in the set have completed,
 	// including sub-tasks enqueued by the tasks themselves (e.g. prosessing a directory tree recursively).
+	// The waiting thread runs queued tasks of the set itself, so a task running in a pool thread can also wait for a set of its own sub-tasks.
 	class TaskSet {
 		ThreadPool *pool = nullptr;
-		int numQueuedTasks = 0;
-		int numRunningTasks = 0;
-		condition_variable emptyCondition;
+		atomic<int> numQueuedTasks{0};
+		atomic<int> numUnfinishedTasks{0}; // Queued or running.
+		atomic<int> numWaitingThreads{0};
+		mutex waitLock; // Only used for sleeping in waitUntilEmpty(), the counters are updated without locking.
+		condition_variable waitCondition;
 
-		bool isEmptyNoSync();
+		void notifyWaitingThreads();
+		void onTaskFinished();
 
 	public:
 		explicit TaskSet(ThreadPool *pool);
@@ -33,10 +39,18 @@ private:
 		TaskRef(const function<void()> &task, TaskSet *taskSet);
 	};
 
+	struct TaskQueue {
+		mutex lock;
+		deque<TaskRef> tasks;
+	};
+
 	int numThreads = 0;
 	int numRunningThreads = 0;
-	deque<TaskRef> taskQueue;
-	bool stopping = false;
+	vector<unique_ptr<TaskQueue>> threadQueues; // One for each pool thread.
+	TaskQueue sharedQueue; // Tasks enqueued by threads not belonging to the pool.
+	atomic<int64_t> numQueuedTasks{0};
+	atomic<int> numSleepingThreads{0};
+	atomic<bool> stopping{false};
 
 	mutex lock;
 	condition_variable threadWakeupCondition;
@@ -45,12 +59,17 @@ private:
 	vector<shared_ptr<thread>> threads;
 
 	void addTaskFromSet(TaskSet *taskSet, const function<void()> &task);
-	void runPoolThread();
+	TaskRef takeTaskFromQueue(TaskQueue *queue, bool newestFirst, TaskSet *taskSetIfOnlyFromSet);
+	TaskRef takeQueuedTask(int threadIndex);
+	TaskRef takeQueuedTaskFromSet(TaskSet *taskSet);
+	void finishTask(const TaskRef &task);
+	void runPoolThread(int threadIndex);
 
 public:
 	explicit ThreadPool(int numThreads);
 	~ThreadPool();
 
+	int getNumThreads() { return numThreads; }
 	void start();
 	void stop();
 	void addTask(const function<void()> &task);
@@ -55,14 +55,20 @@ double getTimeSeconds();
 bool isPowerOfTwo(int64_t v);
 int64_t alignOffsetToNextBoundary(int64_t offset, int64_t alignment);
 
+// A non-owning reference to a string (e.g. in a source code buffer). Use toString() to make a copy that outlives the referenced data.
 struct StringView {
-	const char *ptr;
-	int64_t length;
+	const char *ptr = "";
+	int64_t length = 0;
 
+	StringView() = default;
 	StringView(const char *ptr, int64_t length) : ptr(ptr), length(length) {
 	}
 
+	bool empty() const { return length == 0; }
 	bool operator==(const char *s) const;
+	bool operator==(const string &s) const { return (int64_t)s.size() == length && memcmp(s.data(), ptr, length) == 0; }
+	bool operator!=(const char *s) const { return !(*this == s); }
+	bool operator!=(const string &s) const { return !(*this == s); }
 	string toString() const;
 };
 
@@ -45,6 +45,7 @@ void RabbitCallInternalNamespace::initPartition_partition1(std::string &versionS
 	rabbitCallInternal.typesByName["NonClassEnum"] = new RabbitCallType("NonClassEnum", 0);
 	rabbitCallInternal.typesByName["SpecialCasesStruct"] = new RabbitCallType("SpecialCasesStruct", sizeof(SpecialCasesStruct));
 	rabbitCallInternal.typesByName["TestClassUsingNamespaceStd"] = new RabbitCallType("TestClassUsingNamespaceStd", 0);
+	rabbitCallInternal.typesByName["TestClassWithConstOverloads"] = new RabbitCallType("TestClassWithConstOverloads", 0);
 	rabbitCallInternal.typesByName["IncludedVehicleStruct"] = new RabbitCallType("IncludedVehicleStruct", sizeof(IncludedVehicleStruct));
 	rabbitCallInternal.typesByName["IncludedBicycleStruct"] = new RabbitCallType("IncludedBicycleStruct", sizeof(IncludedBicycleStruct));
 	RabbitCallInternalNamespace::enum_Enum1.setMapping((int64_t)Enum1::VALUE3, "VALUE3");
@@ -153,3 +154,6 @@ _RC_FUNC_EXC(rabbitcall_AnotherDerivedClass_test1(AnotherDerivedClass *_rc_t,_rc
 _RC_FUNC_EXC(rabbitcall_AnotherDerivedClass_test3(AnotherDerivedClass *_rc_t,_rc_PtrAndSize *_rc_r,_rc_PtrAndSize *_rc_e), *_rc_r = _rc_createString(_rc_t->test3());)
 
 _RC_FUNC_EXC(rabbitcall_TestClassUsingNamespaceStd_concatenateStrings(TestClassUsingNamespaceStd *_rc_t,const char *a0,const char *a1,_rc_PtrAndSize *_rc_r,_rc_PtrAndSize *_rc_e), *_rc_r = _rc_createString(_rc_t->concatenateStrings(std::string((const char *)a0),std::string((const char *)a1)));)
+
+_RC_FUNC_EXC(rabbitcall_TestClassWithConstOverloads_getValue(TestClassWithConstOverloads *_rc_t,int *_rc_r,_rc_PtrAndSize *_rc_e), *_rc_r = _rc_t->getValue();)
+_RC_FUNC_EXC(rabbitcall_TestClassWithConstOverloads_getSum(TestClassWithConstOverloads *_rc_t,int *a0,int a1,int *_rc_r,_rc_PtrAndSize *_rc_e), *_rc_r = _rc_t->getSum(a0,a1);)
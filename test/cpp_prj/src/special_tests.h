@@ -105,3 +105,15 @@ public:
 	}
 };
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Const and non-const overloads of a member function. They would have the same signature in the other languages, so only the latter
+// is exported, but their C++ type signatures (used e.g. for stable entry point names) differ.
+
+FXP class TestClassWithConstOverloads {
+public:
+	FXP int getValue() { return 1; }
+	FXP int getValue() const { return 2; }
+	FXP int getSum(const int *values, int count) const { return 3; }
+	FXP int getSum(int * const values, int count) { return 4; }
+};
+
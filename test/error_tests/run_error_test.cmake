@@ -0,0 +1,30 @@
+# Runs the tool on a copy of a test case that is expected to fail, and compares the reported errors to the expected ones.
+# Parameters: TOOL (the rabbitcall executable), CASE_DIR (the test case directory), WORK_DIR (where the case is copied).
+
+file(REMOVE_RECURSE "${WORK_DIR}")
+file(COPY "${CASE_DIR}/" DESTINATION "${WORK_DIR}")
+file(MAKE_DIRECTORY "${WORK_DIR}/out")
+
+execute_process(
+	COMMAND "${TOOL}" -configFile rabbitcall.xml
+	WORKING_DIRECTORY "${WORK_DIR}"
+	RESULT_VARIABLE result
+	OUTPUT_VARIABLE output
+	ERROR_VARIABLE output)
+
+if(result EQUAL 0)
+	message(FATAL_ERROR "Expected the tool to fail, but it succeeded:\n${output}")
+endif()
+
+# Make the source paths relative to the test case directory so that the errors don't depend on where the case was copied.
+file(TO_NATIVE_PATH "${WORK_DIR}/" nativeWorkDir)
+string(REPLACE "${nativeWorkDir}" "" output "${output}")
+string(REPLACE "${WORK_DIR}/" "" output "${output}")
+string(REPLACE "\r\n" "\n" output "${output}")
+
+file(READ "${CASE_DIR}/expected_errors.txt" expected)
+string(REPLACE "\r\n" "\n" expected "${expected}")
+
+if(NOT output STREQUAL expected)
+	message(FATAL_ERROR "Errors differ from ${CASE_DIR}/expected_errors.txt.\nExpected:\n${expected}\nActual:\n${output}")
+endif()
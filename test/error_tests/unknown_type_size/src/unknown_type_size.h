@@ -0,0 +1,23 @@
+#pragma once
+
+// The structs are on the same dependency level, so their layouts are built concurrently.
+
+FXP struct StructWithString {
+	int id;
+	std::string name;
+};
+
+FXP struct StructWithVoidField {
+	float x;
+	void value;
+};
+
+FXP struct StructWithValidFields {
+	int a;
+	float b;
+};
+
+FXP struct StructWithInvalidFieldType {
+	int a;
+	StructWithString nested;
+};
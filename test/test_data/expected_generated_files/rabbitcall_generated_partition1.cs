@@ -452,6 +452,17 @@ namespace CsNamespace {
 		public string concatenateStrings(string s1, string s2)        /****/ {_rc_Ciu._rc_ci();_rc_PtrAndSize _rc_r;_rc_PtrAndSize _rc_e;_rc_f0(_rc_t,s1,s2,&_rc_r,&_rc_e);_rc_Ciu._rc_ce(_rc_e);return _rc_Ciu.readStringUtf8AndFree(_rc_r);} [SuppressUnmanagedCodeSecurity, DllImport(_rc_Ciu._rc_cl, EntryPoint = "rabbitcall_TestClassUsingNamespaceStd_concatenateStrings")] static extern void _rc_f0(void *_rc_t,[MarshalAs(UnmanagedType.LPUTF8Str)] string a0,[MarshalAs(UnmanagedType.LPUTF8Str)] string a1,_rc_PtrAndSize *_rc_r,_rc_PtrAndSize *_rc_e);
 	}
 	
+	public unsafe partial struct NTestClassWithConstOverloads {
+		void *_rc_t;
+		public NTestClassWithConstOverloads(void *ptr) { _rc_t = ptr; }
+		public bool isNull() { return _rc_t == null; }
+		public void * getPtr() { return _rc_t; }
+		
+		public int getValue()        /****/ {_rc_Ciu._rc_ci();int _rc_r;_rc_PtrAndSize _rc_e;_rc_f0(_rc_t,&_rc_r,&_rc_e);_rc_Ciu._rc_ce(_rc_e);return _rc_r;} [SuppressUnmanagedCodeSecurity, DllImport(_rc_Ciu._rc_cl, EntryPoint = "rabbitcall_TestClassWithConstOverloads_getValue")] static extern void _rc_f0(void *_rc_t,int *_rc_r,_rc_PtrAndSize *_rc_e);
+		
+		public int getSum(int *values, int count)        /****/ {_rc_Ciu._rc_ci();int _rc_r;_rc_PtrAndSize _rc_e;_rc_f1(_rc_t,values,count,&_rc_r,&_rc_e);_rc_Ciu._rc_ce(_rc_e);return _rc_r;} [SuppressUnmanagedCodeSecurity, DllImport(_rc_Ciu._rc_cl, EntryPoint = "rabbitcall_TestClassWithConstOverloads_getSum")] static extern void _rc_f1(void *_rc_t,int *a0,int a1,int *_rc_r,_rc_PtrAndSize *_rc_e);
+	}
+	
 	[StructLayout(LayoutKind.Explicit, Size = 4)]
 	public unsafe partial struct IncludedVehicleStruct {
 		[FieldOffset(0)]   public int i;